@@ -0,0 +1,81 @@
+/*
+ * arrowconversion.h
+ *
+ *  Created on: October 19, 2026
+ *      Author: Bjorn Blissing
+ */
+
+#ifndef _COORDINATE_ARROWCONVERSION_H_
+#define _COORDINATE_ARROWCONVERSION_H_ 1
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+	// Structures of the Apache Arrow C Data Interface, as given by the
+	// specification. Guarded so they can coexist with the definitions in
+	// arrow/c/abi.h, nanoarrow or DuckDB.
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+	struct ArrowSchema {
+		const char* format;
+		const char* name;
+		const char* metadata;
+		int64_t flags;
+		int64_t n_children;
+		struct ArrowSchema** children;
+		struct ArrowSchema* dictionary;
+		void (*release)(struct ArrowSchema*);
+		void* private_data;
+	};
+
+	struct ArrowArray {
+		int64_t length;
+		int64_t null_count;
+		int64_t offset;
+		int64_t n_buffers;
+		int64_t n_children;
+		const void** buffers;
+		struct ArrowArray** children;
+		struct ArrowArray* dictionary;
+		void (*release)(struct ArrowArray*);
+		void* private_data;
+	};
+
+#endif // ARROW_C_DATA_INTERFACE
+
+	// Convert two float64 ("g") columns from one coordinate system to another.
+	//
+	// Coordinate systems are "wgs84" or any projection name accepted by
+	// GaussKreuger::swedish_params, e.g. "sweref_99_tm" or "rt90_2.5_gon_v".
+	// For wgs84 the first column is latitude and the second longitude, in
+	// degrees. For grids the first column is x (northing) and the second y
+	// (easting), in metres.
+	//
+	// The input arrays are read in place and are not released. A row that is
+	// null in either input column is null in both output columns.
+	//
+	// On success out_schema and out_array receive a struct array with two
+	// float64 children, named latitude/longitude or x/y after the target. The
+	// caller owns the result and must call its release callbacks.
+	//
+	// Returns 0 on success, EINVAL for unknown coordinate systems,
+	// unsupported arrays or lengths too large to address, and ENOMEM if the
+	// output could not be allocated.
+	int vti_arrow_convert(const char* source, const char* target,
+						  const struct ArrowSchema* first_schema, const struct ArrowArray* first,
+						  const struct ArrowSchema* second_schema, const struct ArrowArray* second,
+						  struct ArrowSchema* out_schema, struct ArrowArray* out_array);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // _COORDINATE_ARROWCONVERSION_H_
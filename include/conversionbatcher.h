@@ -0,0 +1,94 @@
+/*
+ * conversionbatcher.h
+ *
+ *  Created on: October 19, 2026
+ *      Author: Bjorn Blissing
+ */
+
+#ifndef _COORDINATE_CONVERSIONBATCHER_H_
+#define _COORDINATE_CONVERSIONBATCHER_H_ 1
+
+#include "gausskreuger.h"
+#include "rt90position.h"
+#include "sweref99position.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace vti {
+
+	// Coalesces many small conversion requests, e.g. from concurrent web
+	// requests, into larger batches per projection and direction. Callers
+	// submit coordinates and get a future for the result. A background thread
+	// converts a queue when it holds max_batch_size coordinates or when its
+	// oldest request has waited max_latency, whichever comes first.
+	//
+	// Projections are given by the names accepted by GaussKreuger::swedish_params.
+	// Unknown projections give a future holding std::invalid_argument.
+	class ConversionBatcher {
+	public:
+		enum class Direction { GeodeticToGrid, GridToGeodetic };
+
+		explicit ConversionBatcher(size_t maxBatchSize = 256, std::chrono::microseconds maxLatency = std::chrono::microseconds(100));
+		// Converts all pending requests before returning.
+		~ConversionBatcher();
+
+		// Convert a single coordinate. Geodetic coordinates have latitude in x and longitude in y.
+		std::future<GaussKreuger::Coordinate> submit(const std::string& projection, Direction direction, const GaussKreuger::Coordinate& coordinate);
+		// Convert a few coordinates as one request.
+		std::future<std::vector<GaussKreuger::Coordinate> > submit(const std::string& projection, Direction direction,
+				const GaussKreuger::Coordinate* coordinates, size_t count);
+
+		// Convenience versions for the position classes.
+		std::future<GaussKreuger::Coordinate> toWGS84(const RT90Position& position);
+		std::future<GaussKreuger::Coordinate> toWGS84(const SWEREF99Position& position);
+		std::future<GaussKreuger::Coordinate> toRT90(const WGS84Position& position, RT90Position::RT90Projection projection);
+		std::future<GaussKreuger::Coordinate> toSWEREF99(const WGS84Position& position, SWEREF99Position::SWEREFProjection projection);
+
+		// Number of batches converted so far.
+		size_t batches() const;
+	protected:
+		struct Request {
+			size_t offset;
+			size_t count;
+			std::shared_ptr<std::promise<GaussKreuger::Coordinate> > single;
+			std::shared_ptr<std::promise<std::vector<GaussKreuger::Coordinate> > > multiple;
+		};
+
+		struct Queue {
+			Queue() : direction(Direction::GeodeticToGrid) {}
+			GaussKreuger projection;
+			Direction direction;
+			std::vector<GaussKreuger::Coordinate> coordinates;
+			std::vector<Request> requests;
+			std::chrono::steady_clock::time_point deadline; // Of the oldest request.
+		};
+
+		typedef std::pair<std::string, int> QueueKey;
+
+		Queue* queue(const std::string& projection, Direction direction);
+		bool enqueue(Queue& queue, const GaussKreuger::Coordinate* coordinates, size_t count, const Request& request);
+		void run();
+		static void convert(Queue& batch);
+
+		const size_t m_maxBatchSize;
+		const std::chrono::microseconds m_maxLatency;
+		mutable std::mutex m_mutex;
+		std::condition_variable m_condition;
+		std::map<QueueKey, Queue> m_queues;
+		size_t m_batches;
+		bool m_stopping;
+		std::thread m_worker;
+	};
+
+} // namespace vti
+
+#endif // _COORDINATE_CONVERSIONBATCHER_H_
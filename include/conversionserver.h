@@ -0,0 +1,104 @@
+/*
+ * conversionserver.h
+ *
+ *  Created on: October 19, 2026
+ *      Author: Bjorn Blissing
+ */
+
+#ifndef _COORDINATE_CONVERSIONSERVER_H_
+#define _COORDINATE_CONVERSIONSERVER_H_ 1
+
+#include "gausskreuger.h"
+
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace vti {
+
+	// Local conversion daemon. Clients connect over a Unix domain socket and
+	// hand the server a shared memory region on connect. Coordinates are
+	// written to the region in binary form and converted in place; the socket
+	// only carries small fixed size request and response headers.
+	//
+	// The region must hold at least the announced capacity. On Linux it must
+	// be a memfd sealed against shrinking and growing, so a client cannot
+	// truncate it under the server's mapping.
+	//
+	// Only available on POSIX systems.
+	class ConversionServer {
+	public:
+		explicit ConversionServer(const std::string& socketPath);
+		// Closes all connections and removes the socket file.
+		~ConversionServer();
+
+		// Create and bind the listening socket. Returns false, with errno
+		// set, on failure. A socket file at the path is only replaced if no
+		// server accepts connections on it; any other file is an error.
+		bool listen();
+		// Serve clients until stop() is called.
+		void run();
+		// Make run() return. Safe to call from other threads and signal handlers.
+		void stop();
+	protected:
+		struct Client {
+			Client() : fd(-1), memory(nullptr), capacity(0) {}
+			int fd;
+			GaussKreuger::Coordinate* memory; // Null until the handshake is done.
+			size_t capacity; // In coordinates.
+			std::vector<unsigned char> received; // Partially received requests.
+			std::vector<unsigned char> pending; // Responses not yet sent.
+			std::chrono::steady_clock::time_point deadline; // For the handshake.
+		};
+
+		bool accept_client();
+		bool handshake(Client& client);
+		bool serve(Client& client);
+		bool flush(Client& client);
+		void close_client(Client& client);
+		const GaussKreuger* projection(const char* name);
+
+		std::string m_socket_path;
+		int m_listen_fd;
+		int m_stop_pipe[2];
+		std::vector<Client> m_clients;
+		std::map<std::string, GaussKreuger> m_projections;
+	private:
+		ConversionServer(const ConversionServer&);
+		ConversionServer& operator=(const ConversionServer&);
+	};
+
+	// Client for ConversionServer. Large batches are split into chunks that
+	// cycle through a ring of slots in the shared region, so the server can
+	// convert one chunk while the next is being written.
+	class ConversionClient {
+	public:
+		ConversionClient();
+		~ConversionClient();
+
+		// Connect and set up a shared region holding capacity coordinates.
+		bool connect(const std::string& socketPath, size_t capacity = 65536);
+		void disconnect();
+		bool is_connected() const { return m_fd >= 0; }
+
+		// Convert a batch. Geodetic coordinates have latitude in x and longitude in y.
+		// Input and output may be the same array. Returns false if the
+		// projection is unknown or the connection fails.
+		bool geodetic_to_grid(const char* projection, const GaussKreuger::Coordinate* geodetic, GaussKreuger::Coordinate* grid, size_t count);
+		bool grid_to_geodetic(const char* projection, const GaussKreuger::Coordinate* grid, GaussKreuger::Coordinate* geodetic, size_t count);
+	protected:
+		bool convert(const char* projection, unsigned direction, const GaussKreuger::Coordinate* input, GaussKreuger::Coordinate* output, size_t count);
+
+		int m_fd;
+		GaussKreuger::Coordinate* m_memory;
+		size_t m_capacity;
+	private:
+		ConversionClient(const ConversionClient&);
+		ConversionClient& operator=(const ConversionClient&);
+	};
+
+} // namespace vti
+
+#endif // _COORDINATE_CONVERSIONSERVER_H_
@@ -0,0 +1,28 @@
+/*
+ * ellipsoid.h
+ *
+ *  Created on: October 19, 2026
+ *      Author: Bjorn Blissing
+ */
+
+#ifndef _COORDINATE_ELLIPSOID_H_
+#define _COORDINATE_ELLIPSOID_H_ 1
+
+namespace vti {
+
+	struct Ellipsoid {
+		Ellipsoid(double semiMajorAxis, double inverseFlattening) : axis(semiMajorAxis), flattening(1.0 / inverseFlattening) {}
+
+		// GRS 80, used by SWEREF 99. WGS 84 coincides with GRS 80 well below
+		// the precision of this library.
+		static Ellipsoid grs80() { return Ellipsoid(6378137.0, 298.257222101); }
+		// Bessel 1841, used by the original RT 90.
+		static Ellipsoid bessel() { return Ellipsoid(6377397.155, 299.1528128); }
+
+		double axis; // Semi-major axis of the ellipsoid.
+		double flattening; // Flattening of the ellipsoid.
+	};
+
+} // namespace vti
+
+#endif // _COORDINATE_ELLIPSOID_H_
@@ -0,0 +1,48 @@
+/*
+ * envelopetransform.h
+ *
+ *  Created on: October 19, 2026
+ *      Author: Bjorn Blissing
+ */
+
+#ifndef _COORDINATE_ENVELOPETRANSFORM_H_
+#define _COORDINATE_ENVELOPETRANSFORM_H_ 1
+
+#include "gausskreuger.h"
+
+#include <cstddef>
+
+namespace vti {
+
+	// Transformation of bounding boxes, e.g. map viewports or dataset extents,
+	// between coordinate systems. The edges of a rectangle are curved in the
+	// target system, so transforming the corners is not enough. Each edge is
+	// bisected only where the transformed midpoint deviates from the chord by
+	// more than the tolerance, and the result is the bounding box of all
+	// evaluated points grown by the tolerance.
+	//
+	// A projection pointer that is null means geodetic WGS84 coordinates
+	// (latitude in x, longitude in y, in degrees). The tolerance is given in
+	// target coordinate units.
+	class EnvelopeTransform {
+	public:
+		EnvelopeTransform(const GaussKreuger* sourceProjection, const GaussKreuger* targetProjection, double tolerance);
+
+		// Transform a bounding box. The number of points evaluated is
+		// written to evaluations unless it is null.
+		GaussKreuger::Bounds transform(const GaussKreuger::Bounds& bounds, size_t* evaluations = nullptr) const;
+		// Exact transformation of a single coordinate.
+		GaussKreuger::Coordinate transform(const GaussKreuger::Coordinate& source) const;
+	protected:
+		void densify(const GaussKreuger::Coordinate& sourceBegin, const GaussKreuger::Coordinate& sourceEnd,
+					 const GaussKreuger::Coordinate& targetBegin, const GaussKreuger::Coordinate& targetEnd,
+					 int depth, GaussKreuger::Bounds& result, size_t& evaluations) const;
+
+		const GaussKreuger* m_sourceProjection;
+		const GaussKreuger* m_targetProjection;
+		double m_tolerance;
+	};
+
+} // namespace vti
+
+#endif // _COORDINATE_ENVELOPETRANSFORM_H_
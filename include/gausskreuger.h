@@ -8,6 +8,7 @@
 #ifndef _COORDINATE_GAUSSKREUGER_H_
 #define _COORDINATE_GAUSSKREUGER_H_ 1
 
+#include <cstddef>
 #include <string>
 
 namespace vti {
@@ -20,21 +21,125 @@ namespace vti {
 			double y;
 		};
 
+		// Axis aligned bounding box. For geodetic coordinates x is latitude and y longitude.
+		struct Bounds {
+			Bounds() : min_x(0.0), min_y(0.0), max_x(0.0), max_y(0.0) {}
+			bool contains(double x, double y) const
+			{
+				return x >= min_x && x <= max_x && y >= min_y && y <= max_y;
+			}
+			double min_x;
+			double min_y;
+			double max_x;
+			double max_y;
+		};
+
+		// Partial derivatives of the grid coordinates with respect to the
+		// geodetic coordinates, in metres per degree.
+		struct Jacobian {
+			Jacobian() : dx_dlatitude(0.0), dx_dlongitude(0.0), dy_dlatitude(0.0), dy_dlongitude(0.0) {}
+			double dx_dlatitude;
+			double dx_dlongitude;
+			double dy_dlatitude;
+			double dy_dlongitude;
+		};
+
+		// Symmetric 2x2 covariance of a Coordinate. In square degrees for
+		// geodetic coordinates, with latitude in x, and in square metres for
+		// grid coordinates.
+		struct Covariance {
+			Covariance() : xx(0.0), xy(0.0), yy(0.0) {}
+			double xx;
+			double xy;
+			double yy;
+		};
+
+		GaussKreuger();
+
 		// Parameters for RT90 and SWEREF99TM.
 		// Note: Parameters for RT90 are choosen to eliminate the
 		// differences between Bessel and GRS80-ellipsoides.
 		// Bessel-variants should only be used if lat/long are given as
 		// RT90-lat/long based on the Bessel ellipsoide (from old maps).
 		// Parameter: projection (std::string). Must match if-statement.
-		void swedish_params(const std::string& projection);
+		// Returns false if the projection is unknown.
+		bool swedish_params(const std::string& projection);
+		// Same as above, but never allocates. Safe to call from real-time code.
+		bool swedish_params(const char* projection) noexcept;
 		// Conversion from geodetic coordinates to grid coordinates.
-		Coordinate geodetic_to_grid(double latitude, double longitude) const;
+		Coordinate geodetic_to_grid(double latitude, double longitude) const noexcept;
 		// Conversion from grid coordinates to geodetic coordinates.
-		Coordinate grid_to_geodetic(double x, double y) const;
+		Coordinate grid_to_geodetic(double x, double y) const noexcept;
+		// Batch conversion from geodetic coordinates (latitude in x, longitude in y)
+		// to grid coordinates. The series constants are computed once per batch.
+		// Input and output may refer to the same array.
+		void geodetic_to_grid(const Coordinate* geodetic, Coordinate* grid, size_t count) const noexcept;
+		// Batch conversion from grid coordinates to geodetic coordinates.
+		// Input and output may refer to the same array.
+		void grid_to_geodetic(const Coordinate* grid, Coordinate* geodetic, size_t count) const noexcept;
+		// Batch conversions that only convert points within the area of use of
+		// the projection. valid[i] is set to 1 for converted points and 0 for
+		// rejected points, whose output is set to NaN. The bounds are checked
+		// for the whole batch before any conversion, so rejected points never
+		// reach the series expansion. Returns the number of valid points.
+		size_t geodetic_to_grid(const Coordinate* geodetic, Coordinate* grid, unsigned char* valid, size_t count) const noexcept;
+		size_t grid_to_geodetic(const Coordinate* grid, Coordinate* geodetic, unsigned char* valid, size_t count) const noexcept;
+
+		// Point scale factor of the projection at the given geodetic coordinate,
+		// i.e. grid distance divided by distance on the ellipsoid.
+		double scale_factor(double latitude, double longitude) const noexcept;
+		// Analytic Jacobian of geodetic_to_grid, from the partial derivatives
+		// of the Kruger series.
+		Jacobian jacobian(double latitude, double longitude) const noexcept;
+
+		// Conversions that also propagate a position covariance to first
+		// order, C' = J C J^T, with the Jacobian at the point. The inverse
+		// uses the inverted Jacobian at the converted point. Much cheaper than
+		// sampling and first-order accurate: the neglected higher order terms
+		// stay small while the uncertainty is small compared to the curvature
+		// of the projection, i.e. up to kilometres.
+		Coordinate geodetic_to_grid(double latitude, double longitude, const Covariance& geodeticCovariance, Covariance& gridCovariance) const noexcept;
+		Coordinate grid_to_geodetic(double x, double y, const Covariance& gridCovariance, Covariance& geodeticCovariance) const noexcept;
+		// Batch versions. Coordinates and covariances may be converted in place.
+		void geodetic_to_grid(const Coordinate* geodetic, const Covariance* geodeticCovariance,
+							  Coordinate* grid, Covariance* gridCovariance, size_t count) const noexcept;
+		void grid_to_geodetic(const Coordinate* grid, const Covariance* gridCovariance,
+							  Coordinate* geodetic, Covariance* geodeticCovariance, size_t count) const noexcept;
+
+		// True if swedish_params has been called with a known projection.
+		bool is_valid() const noexcept;
+		// Area of use of the projection in geodetic coordinates. This is the
+		// extent of Sweden for SWEREF 99 TM and RT90 2.5 gon V, and a band of
+		// 1.5 degrees on each side of the central meridian for the zones.
+		const Bounds& geodetic_bounds() const noexcept { return m_area_of_use; }
+		// Bounding box of the area of use in grid coordinates.
+		Bounds grid_bounds() const noexcept;
 	protected:
-		void grs80_params();
-		void bessel_params();
-		void sweref99_params();
+		// Ellipsoid-based constants for the forward series.
+		struct ForwardConstants {
+			double a_roof;
+			double A, B, C, D;
+			double beta1, beta2, beta3, beta4;
+		};
+		// Ellipsoid-based constants for the inverse series.
+		struct InverseConstants {
+			double a_roof;
+			double delta1, delta2, delta3, delta4;
+			double Astar, Bstar, Cstar, Dstar;
+		};
+
+		void forward_constants(ForwardConstants& constants) const noexcept;
+		void inverse_constants(InverseConstants& constants) const noexcept;
+		Coordinate geodetic_to_grid(const ForwardConstants& constants, double latitude, double longitude) const noexcept;
+		Coordinate grid_to_geodetic(const InverseConstants& constants, double x, double y) const noexcept;
+		// Grid coordinate and Jacobian in one pass over the series.
+		Coordinate geodetic_to_grid(const ForwardConstants& constants, double latitude, double longitude, Jacobian& jacobian) const noexcept;
+		static Covariance propagate(const Jacobian& jacobian, const Covariance& covariance) noexcept;
+		static Covariance propagate_inverse(const Jacobian& jacobian, const Covariance& covariance) noexcept;
+
+		void grs80_params() noexcept;
+		void bessel_params() noexcept;
+		void sweref99_params() noexcept;
 
 		double m_axis; // Semi-major axis of the ellipsoid.
 		double m_flattening; // Flattening of the ellipsoid.
@@ -42,8 +147,20 @@ namespace vti {
 		double m_scale; // Scale on central meridian.
 		double m_false_northing; // Offset for origo.
 		double m_false_easting; // Offset for origo.
+		Bounds m_area_of_use; // Geodetic area of use.
 	};
 
 } // namespace vti
 
+// Header-only mode, see the coordinate-transformation-kernels target. The
+// library defines the same functions out of line, so a target uses either
+// the library or the header-only kernels, never both.
+#ifdef VTI_HEADER_ONLY
+#ifdef VTI_KERNELS_IN_LIBRARY
+#error "Link either coordinate-transformation or coordinate-transformation-kernels, not both"
+#endif
+#define VTI_INLINE inline
+#include "gausskreuger.inl"
+#endif
+
 #endif // _COORDINATE_GAUSSKREUGER_H_
@@ -0,0 +1,678 @@
+/*
+ * gausskreuger.inl
+ *
+ *  Created on: March 11, 2015
+ *      Author: Bjorn Blissing
+ */
+
+// Implementation of GaussKreuger. Compiled into the library by
+// src/gausskreuger.cpp, or included by gausskreuger.h with every function
+// inline when VTI_HEADER_ONLY is defined.
+
+#ifndef _COORDINATE_GAUSSKREUGER_INL_
+#define _COORDINATE_GAUSSKREUGER_INL_ 1
+
+#include "gausskreuger.h"
+#include "ellipsoid.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#ifndef M_PI
+#define M_PI 3.1415926535897932384626433832
+#endif
+
+#ifndef VTI_INLINE
+#define VTI_INLINE
+#endif
+
+namespace vti {
+
+namespace {
+
+// Extent of Sweden (EPSG area 1225).
+const double sweden_min_latitude = 54.96;
+const double sweden_max_latitude = 69.07;
+const double sweden_min_longitude = 10.03;
+const double sweden_max_longitude = 24.17;
+// Half width of the area of use for zone projections.
+const double zone_half_width = 1.5;
+
+} // namespace
+
+VTI_INLINE GaussKreuger::GaussKreuger() :
+	m_axis(0.0),
+	m_flattening(0.0),
+	m_central_meridian(std::numeric_limits<double>::min()),
+	m_scale(0.0),
+	m_false_northing(0.0),
+	m_false_easting(0.0)
+{
+}
+
+VTI_INLINE bool GaussKreuger::swedish_params(const std::string& projection)
+{
+	return swedish_params(projection.c_str());
+}
+
+VTI_INLINE bool GaussKreuger::swedish_params(const char* projection) noexcept
+{
+	// RT90 parameters, GRS 80 ellipsoid.
+	if (std::strcmp(projection, "rt90_7.5_gon_v") == 0) {
+		grs80_params();
+		m_central_meridian = 11.0 + 18.375 / 60.0;
+		m_scale = 1.000006000000;
+		m_false_northing = -667.282;
+		m_false_easting = 1500025.141;
+	} else if (std::strcmp(projection, "rt90_5.0_gon_v") == 0) {
+		grs80_params();
+		m_central_meridian = 13.0 + 33.376 / 60.0;
+		m_scale = 1.000005800000;
+		m_false_northing = -667.130;
+		m_false_easting = 1500044.695;
+	} else if (std::strcmp(projection, "rt90_2.5_gon_v") == 0) {
+		grs80_params();
+		m_central_meridian = 15.0 + 48.0 / 60.0 + 22.624306 / 3600.0;
+		m_scale = 1.00000561024;
+		m_false_northing = -667.711;
+		m_false_easting = 1500064.274;
+	} else if (std::strcmp(projection, "rt90_0.0_gon_v") == 0) {
+		grs80_params();
+		m_central_meridian = 18.0 + 3.378 / 60.0;
+		m_scale = 1.000005400000;
+		m_false_northing = -668.844;
+		m_false_easting = 1500083.521;
+	} else if (std::strcmp(projection, "rt90_2.5_gon_o") == 0) {
+		grs80_params();
+		m_central_meridian = 20.0 + 18.379 / 60.0;
+		m_scale = 1.000005200000;
+		m_false_northing = -670.706;
+		m_false_easting = 1500102.765;
+	} else if (std::strcmp(projection, "rt90_5.0_gon_o") == 0) {
+		grs80_params();
+		m_central_meridian = 22.0 + 33.380 / 60.0;
+		m_scale = 1.000004900000;
+		m_false_northing = -672.557;
+		m_false_easting = 1500121.846;
+	} // RT90 parameters, Bessel 1841 ellipsoid.
+	else if (std::strcmp(projection, "bessel_rt90_7.5_gon_v") == 0) {
+		bessel_params();
+		m_central_meridian = 11.0 + 18.0 / 60.0 + 29.8 / 3600.0;
+	} else if (std::strcmp(projection, "bessel_rt90_5.0_gon_v") == 0) {
+		bessel_params();
+		m_central_meridian = 13.0 + 33.0 / 60.0 + 29.8 / 3600.0;
+	} else if (std::strcmp(projection, "bessel_rt90_2.5_gon_v") == 0) {
+		bessel_params();
+		m_central_meridian = 15.0 + 48.0 / 60.0 + 29.8 / 3600.0;
+	} else if (std::strcmp(projection, "bessel_rt90_0.0_gon_v") == 0) {
+		bessel_params();
+		m_central_meridian = 18.0 + 3.0 / 60.0 + 29.8 / 3600.0;
+	} else if (std::strcmp(projection, "bessel_rt90_2.5_gon_o") == 0) {
+		bessel_params();
+		m_central_meridian = 20.0 + 18.0 / 60.0 + 29.8 / 3600.0;
+	} else if (std::strcmp(projection, "bessel_rt90_5.0_gon_o") == 0) {
+		bessel_params();
+		m_central_meridian = 22.0 + 33.0 / 60.0 + 29.8 / 3600.0;
+	} // SWEREF99TM and SWEREF99ddmm parameters.
+	else if (std::strcmp(projection, "sweref_99_tm") == 0) {
+		sweref99_params();
+		m_central_meridian = 15.00;
+		m_scale = 0.9996;
+		m_false_northing = 0.0;
+		m_false_easting = 500000.0;
+	} else if (std::strcmp(projection, "sweref_99_1200") == 0) {
+		sweref99_params();
+		m_central_meridian = 12.00;
+	} else if (std::strcmp(projection, "sweref_99_1330") == 0) {
+		sweref99_params();
+		m_central_meridian = 13.50;
+	} else if (std::strcmp(projection, "sweref_99_1500") == 0) {
+		sweref99_params();
+		m_central_meridian = 15.00;
+	} else if (std::strcmp(projection, "sweref_99_1630") == 0) {
+		sweref99_params();
+		m_central_meridian = 16.50;
+	} else if (std::strcmp(projection, "sweref_99_1800") == 0) {
+		sweref99_params();
+		m_central_meridian = 18.00;
+	} else if (std::strcmp(projection, "sweref_99_1415") == 0) {
+		sweref99_params();
+		m_central_meridian = 14.25;
+	} else if (std::strcmp(projection, "sweref_99_1545") == 0) {
+		sweref99_params();
+		m_central_meridian = 15.75;
+	} else if (std::strcmp(projection, "sweref_99_1715") == 0) {
+		sweref99_params();
+		m_central_meridian = 17.25;
+	} else if (std::strcmp(projection, "sweref_99_1845") == 0) {
+		sweref99_params();
+		m_central_meridian = 18.75;
+	} else if (std::strcmp(projection, "sweref_99_2015") == 0) {
+		sweref99_params();
+		m_central_meridian = 20.25;
+	} else if (std::strcmp(projection, "sweref_99_2145") == 0) {
+		sweref99_params();
+		m_central_meridian = 21.75;
+	} else if (std::strcmp(projection, "sweref_99_2315") == 0) {
+		sweref99_params();
+		m_central_meridian = 23.25;
+	} else {
+		m_central_meridian = std::numeric_limits<double>::min();
+		m_area_of_use = Bounds();
+		return false;
+	}
+
+	// Area of use.
+	m_area_of_use.min_x = sweden_min_latitude;
+	m_area_of_use.max_x = sweden_max_latitude;
+
+	if (std::strcmp(projection, "sweref_99_tm") == 0 ||
+		std::strcmp(projection, "rt90_2.5_gon_v") == 0 ||
+		std::strcmp(projection, "bessel_rt90_2.5_gon_v") == 0) {
+		m_area_of_use.min_y = sweden_min_longitude;
+		m_area_of_use.max_y = sweden_max_longitude;
+	} else {
+		m_area_of_use.min_y = m_central_meridian - zone_half_width;
+		m_area_of_use.max_y = m_central_meridian + zone_half_width;
+	}
+
+	return true;
+}
+
+VTI_INLINE bool GaussKreuger::is_valid() const noexcept
+{
+	return m_central_meridian != std::numeric_limits<double>::min();
+}
+
+VTI_INLINE GaussKreuger::Bounds GaussKreuger::grid_bounds() const noexcept
+{
+	Bounds bounds;
+
+	if (!is_valid()) {
+		return bounds;
+	}
+
+	// The central meridian lies within the area of use. Parallels bend
+	// towards the pole away from the central meridian and the distance to
+	// the central meridian shrinks with latitude, so the extremes of the
+	// projected area are found at these points.
+	const Bounds& area = m_area_of_use;
+	Coordinate south = geodetic_to_grid(area.min_x, m_central_meridian);
+	Coordinate north_west = geodetic_to_grid(area.max_x, area.min_y);
+	Coordinate north_east = geodetic_to_grid(area.max_x, area.max_y);
+	Coordinate south_west = geodetic_to_grid(area.min_x, area.min_y);
+	Coordinate south_east = geodetic_to_grid(area.min_x, area.max_y);
+	// Allow for the millimetre rounding of the grid coordinates.
+	const double margin = 0.001;
+	bounds.min_x = south.x - margin;
+	bounds.max_x = (north_west.x > north_east.x ? north_west.x : north_east.x) + margin;
+	bounds.min_y = south_west.y - margin;
+	bounds.max_y = south_east.y + margin;
+	return bounds;
+}
+
+VTI_INLINE void GaussKreuger::grs80_params() noexcept
+{
+	const Ellipsoid grs80 = Ellipsoid::grs80();
+	m_axis = grs80.axis;
+	m_flattening = grs80.flattening;
+	m_central_meridian = std::numeric_limits<double>::min();
+}
+
+VTI_INLINE void GaussKreuger::bessel_params() noexcept
+{
+	const Ellipsoid bessel = Ellipsoid::bessel();
+	m_axis = bessel.axis;
+	m_flattening = bessel.flattening;
+	m_central_meridian = std::numeric_limits<double>::min();
+	m_scale = 1.0;
+	m_false_northing = 0.0;
+	m_false_easting = 1500000.0;
+}
+
+VTI_INLINE void GaussKreuger::sweref99_params() noexcept
+{
+	const Ellipsoid grs80 = Ellipsoid::grs80();
+	m_axis = grs80.axis;
+	m_flattening = grs80.flattening;
+	m_central_meridian = std::numeric_limits<double>::min();
+	m_scale = 1.0;
+	m_false_northing = 0.0;
+	m_false_easting = 150000.0;
+}
+
+VTI_INLINE void GaussKreuger::forward_constants(ForwardConstants& constants) const noexcept
+{
+	double e2 = m_flattening * (2.0 - m_flattening);
+	double n = m_flattening / (2.0 - m_flattening);
+	constants.a_roof = m_axis / (1.0 + n) * (1.0 + n * n / 4.0 + n * n * n * n / 64.0);
+	constants.A = e2;
+	constants.B = (5.0 * e2 * e2 - e2 * e2 * e2) / 6.0;
+	constants.C = (104.0 * e2 * e2 * e2 - 45.0 * e2 * e2 * e2 * e2) / 120.0;
+	constants.D = (1237.0 * e2 * e2 * e2 * e2) / 1260.0;
+	constants.beta1 = n / 2.0 - 2.0 * n * n / 3.0 + 5.0 * n * n * n / 16.0 + 41.0 * n * n * n * n / 180.0;
+	constants.beta2 = 13.0 * n * n / 48.0 - 3.0 * n * n * n / 5.0 + 557.0 * n * n * n * n / 1440.0;
+	constants.beta3 = 61.0 * n * n * n / 240.0 - 103.0 * n * n * n * n / 140.0;
+	constants.beta4 = 49561.0 * n * n * n * n / 161280.0;
+}
+
+VTI_INLINE void GaussKreuger::inverse_constants(InverseConstants& constants) const noexcept
+{
+	double e2 = m_flattening * (2.0 - m_flattening);
+	double n = m_flattening / (2.0 - m_flattening);
+	constants.a_roof = m_axis / (1.0 + n) * (1.0 + n * n / 4.0 + n * n * n * n / 64.0);
+	constants.delta1 = n / 2.0 - 2.0 * n * n / 3.0 + 37.0 * n * n * n / 96.0 - n * n * n * n / 360.0;
+	constants.delta2 = n * n / 48.0 + n * n * n / 15.0 - 437.0 * n * n * n * n / 1440.0;
+	constants.delta3 = 17.0 * n * n * n / 480.0 - 37 * n * n * n * n / 840.0;
+	constants.delta4 = 4397.0 * n * n * n * n / 161280.0;
+	constants.Astar = e2 + e2 * e2 + e2 * e2 * e2 + e2 * e2 * e2 * e2;
+	constants.Bstar = -(7.0 * e2 * e2 + 17.0 * e2 * e2 * e2 + 30.0 * e2 * e2 * e2 * e2) / 6.0;
+	constants.Cstar = (224.0 * e2 * e2 * e2 + 889.0 * e2 * e2 * e2 * e2) / 120.0;
+	constants.Dstar = -(4279.0 * e2 * e2 * e2 * e2) / 1260.0;
+}
+
+VTI_INLINE GaussKreuger::Coordinate GaussKreuger::geodetic_to_grid(double latitude, double longitude) const noexcept
+{
+	// Prepare ellipsoid-based stuff.
+	ForwardConstants constants;
+	forward_constants(constants);
+	return geodetic_to_grid(constants, latitude, longitude);
+}
+
+VTI_INLINE GaussKreuger::Coordinate GaussKreuger::grid_to_geodetic(double x, double y) const noexcept
+{
+	// Prepare ellipsoid-based stuff.
+	InverseConstants constants;
+	inverse_constants(constants);
+	return grid_to_geodetic(constants, x, y);
+}
+
+VTI_INLINE void GaussKreuger::geodetic_to_grid(const Coordinate* geodetic, Coordinate* grid, size_t count) const noexcept
+{
+	ForwardConstants constants;
+	forward_constants(constants);
+
+	for (size_t i = 0; i < count; ++i) {
+		grid[i] = geodetic_to_grid(constants, geodetic[i].x, geodetic[i].y);
+	}
+}
+
+VTI_INLINE void GaussKreuger::grid_to_geodetic(const Coordinate* grid, Coordinate* geodetic, size_t count) const noexcept
+{
+	InverseConstants constants;
+	inverse_constants(constants);
+
+	for (size_t i = 0; i < count; ++i) {
+		geodetic[i] = grid_to_geodetic(constants, grid[i].x, grid[i].y);
+	}
+}
+
+VTI_INLINE size_t GaussKreuger::geodetic_to_grid(const Coordinate* geodetic, Coordinate* grid, unsigned char* valid, size_t count) const noexcept
+{
+	const Bounds& area = m_area_of_use;
+	const bool known = is_valid();
+
+	// Branch free bounds check over the whole batch. NaN fails every comparison.
+	for (size_t i = 0; i < count; ++i) {
+		const double x = geodetic[i].x;
+		const double y = geodetic[i].y;
+		valid[i] = static_cast<unsigned char>(known & (x >= area.min_x) & (x <= area.max_x) & (y >= area.min_y) & (y <= area.max_y));
+	}
+
+	ForwardConstants constants;
+	forward_constants(constants);
+	size_t converted = 0;
+
+	for (size_t i = 0; i < count; ++i) {
+		if (valid[i]) {
+			grid[i] = geodetic_to_grid(constants, geodetic[i].x, geodetic[i].y);
+			++converted;
+		} else {
+			grid[i].x = std::numeric_limits<double>::quiet_NaN();
+			grid[i].y = std::numeric_limits<double>::quiet_NaN();
+		}
+	}
+
+	return converted;
+}
+
+VTI_INLINE size_t GaussKreuger::grid_to_geodetic(const Coordinate* grid, Coordinate* geodetic, unsigned char* valid, size_t count) const noexcept
+{
+	const Bounds bounds = grid_bounds();
+	const bool known = is_valid();
+
+	// Cheap rejection against the projected bounding box first.
+	for (size_t i = 0; i < count; ++i) {
+		const double x = grid[i].x;
+		const double y = grid[i].y;
+		valid[i] = static_cast<unsigned char>(known & (x >= bounds.min_x) & (x <= bounds.max_x) & (y >= bounds.min_y) & (y <= bounds.max_y));
+	}
+
+	InverseConstants constants;
+	inverse_constants(constants);
+	const Bounds& area = m_area_of_use;
+	size_t converted = 0;
+
+	for (size_t i = 0; i < count; ++i) {
+		if (valid[i]) {
+			Coordinate lat_lon = grid_to_geodetic(constants, grid[i].x, grid[i].y);
+			// The bounding box is larger than the area of use near its corners.
+			valid[i] = area.contains(lat_lon.x, lat_lon.y) ? 1 : 0;
+
+			if (valid[i]) {
+				geodetic[i] = lat_lon;
+				++converted;
+				continue;
+			}
+		}
+
+		geodetic[i].x = std::numeric_limits<double>::quiet_NaN();
+		geodetic[i].y = std::numeric_limits<double>::quiet_NaN();
+	}
+
+	return converted;
+}
+
+VTI_INLINE double GaussKreuger::scale_factor(double latitude, double longitude) const noexcept
+{
+	ForwardConstants constants;
+	forward_constants(constants);
+	const double A = constants.A;
+	const double B = constants.B;
+	const double C = constants.C;
+	const double D = constants.D;
+	const double beta1 = constants.beta1;
+	const double beta2 = constants.beta2;
+	const double beta3 = constants.beta3;
+	const double beta4 = constants.beta4;
+	double e2 = m_flattening * (2.0 - m_flattening);
+	double deg_to_rad = M_PI / 180.0;
+	double phi = latitude * deg_to_rad;
+	double phi_star = phi - sin(phi) * cos(phi) * (A +
+					  B * pow(sin(phi), 2) +
+					  C * pow(sin(phi), 4) +
+					  D * pow(sin(phi), 6));
+	double delta_lambda = (longitude - m_central_meridian) * deg_to_rad;
+	double xi_prim = atan(tan(phi_star) / cos(delta_lambda));
+	double eta_prim = atanh(cos(phi_star) * sin(delta_lambda));
+	// The projection is conformal, so the scale is the same in all directions.
+	// Take the derivative along the parallel: first from longitude to the
+	// (xi', eta') plane, then through the Kruger series.
+	double u = tan(phi_star) / cos(delta_lambda);
+	double v = cos(phi_star) * sin(delta_lambda);
+	double dxi_dlambda = tan(phi_star) * sin(delta_lambda) / (cos(delta_lambda) * cos(delta_lambda) * (1.0 + u * u));
+	double deta_dlambda = cos(phi_star) * cos(delta_lambda) / (1.0 - v * v);
+	double p = 1.0 +
+			   2.0 * beta1 * cos(2.0 * xi_prim) * cosh(2.0 * eta_prim) +
+			   4.0 * beta2 * cos(4.0 * xi_prim) * cosh(4.0 * eta_prim) +
+			   6.0 * beta3 * cos(6.0 * xi_prim) * cosh(6.0 * eta_prim) +
+			   8.0 * beta4 * cos(8.0 * xi_prim) * cosh(8.0 * eta_prim);
+	double q = 2.0 * beta1 * sin(2.0 * xi_prim) * sinh(2.0 * eta_prim) +
+			   4.0 * beta2 * sin(4.0 * xi_prim) * sinh(4.0 * eta_prim) +
+			   6.0 * beta3 * sin(6.0 * xi_prim) * sinh(6.0 * eta_prim) +
+			   8.0 * beta4 * sin(8.0 * xi_prim) * sinh(8.0 * eta_prim);
+	// Length of a radian of longitude along the parallel.
+	double parallel_radius = m_axis * cos(phi) / sqrt(1.0 - e2 * sin(phi) * sin(phi));
+	return m_scale * constants.a_roof * sqrt(p * p + q * q) *
+		   sqrt(dxi_dlambda * dxi_dlambda + deta_dlambda * deta_dlambda) / parallel_radius;
+}
+
+VTI_INLINE GaussKreuger::Jacobian GaussKreuger::jacobian(double latitude, double longitude) const noexcept
+{
+	ForwardConstants constants;
+	forward_constants(constants);
+	Jacobian result;
+	geodetic_to_grid(constants, latitude, longitude, result);
+	return result;
+}
+
+VTI_INLINE GaussKreuger::Coordinate GaussKreuger::geodetic_to_grid(double latitude, double longitude, const Covariance& geodeticCovariance, Covariance& gridCovariance) const noexcept
+{
+	ForwardConstants constants;
+	forward_constants(constants);
+	Jacobian derivatives;
+	Coordinate x_y = geodetic_to_grid(constants, latitude, longitude, derivatives);
+	gridCovariance = propagate(derivatives, geodeticCovariance);
+	return x_y;
+}
+
+VTI_INLINE GaussKreuger::Coordinate GaussKreuger::grid_to_geodetic(double x, double y, const Covariance& gridCovariance, Covariance& geodeticCovariance) const noexcept
+{
+	InverseConstants inverse;
+	inverse_constants(inverse);
+	ForwardConstants forward;
+	forward_constants(forward);
+	Coordinate lat_lon = grid_to_geodetic(inverse, x, y);
+	Jacobian derivatives;
+	geodetic_to_grid(forward, lat_lon.x, lat_lon.y, derivatives);
+	geodeticCovariance = propagate_inverse(derivatives, gridCovariance);
+	return lat_lon;
+}
+
+VTI_INLINE void GaussKreuger::geodetic_to_grid(const Coordinate* geodetic, const Covariance* geodeticCovariance,
+		Coordinate* grid, Covariance* gridCovariance, size_t count) const noexcept
+{
+	ForwardConstants constants;
+	forward_constants(constants);
+	Jacobian derivatives;
+
+	for (size_t i = 0; i < count; ++i) {
+		grid[i] = geodetic_to_grid(constants, geodetic[i].x, geodetic[i].y, derivatives);
+		gridCovariance[i] = propagate(derivatives, geodeticCovariance[i]);
+	}
+}
+
+VTI_INLINE void GaussKreuger::grid_to_geodetic(const Coordinate* grid, const Covariance* gridCovariance,
+		Coordinate* geodetic, Covariance* geodeticCovariance, size_t count) const noexcept
+{
+	InverseConstants inverse;
+	inverse_constants(inverse);
+	ForwardConstants forward;
+	forward_constants(forward);
+	Jacobian derivatives;
+
+	for (size_t i = 0; i < count; ++i) {
+		geodetic[i] = grid_to_geodetic(inverse, grid[i].x, grid[i].y);
+		geodetic_to_grid(forward, geodetic[i].x, geodetic[i].y, derivatives);
+		geodeticCovariance[i] = propagate_inverse(derivatives, gridCovariance[i]);
+	}
+}
+
+VTI_INLINE GaussKreuger::Coordinate GaussKreuger::geodetic_to_grid(const ForwardConstants& constants, double latitude, double longitude) const noexcept
+{
+	Coordinate x_y;
+	const double A = constants.A;
+	const double B = constants.B;
+	const double C = constants.C;
+	const double D = constants.D;
+	const double beta1 = constants.beta1;
+	const double beta2 = constants.beta2;
+	const double beta3 = constants.beta3;
+	const double beta4 = constants.beta4;
+	// Convert.
+	double deg_to_rad = M_PI / 180.0;
+	double phi = latitude * deg_to_rad;
+	double lambda = longitude * deg_to_rad;
+	double lambda_zero = m_central_meridian * deg_to_rad;
+	double phi_star = phi - sin(phi) * cos(phi) * (A +
+					  B * pow(sin(phi), 2) +
+					  C * pow(sin(phi), 4) +
+					  D * pow(sin(phi), 6));
+	double delta_lambda = lambda - lambda_zero;
+	double xi_prim = atan(tan(phi_star) / cos(delta_lambda));
+	double eta_prim = atanh(cos(phi_star) * sin(delta_lambda));
+	double x = m_scale * constants.a_roof * (xi_prim +
+								   beta1 * sin(2.0 * xi_prim) * cosh(2.0 * eta_prim) +
+								   beta2 * sin(4.0 * xi_prim) * cosh(4.0 * eta_prim) +
+								   beta3 * sin(6.0 * xi_prim) * cosh(6.0 * eta_prim) +
+								   beta4 * sin(8.0 * xi_prim) * cosh(8.0 * eta_prim)) +
+			   m_false_northing;
+	double y = m_scale * constants.a_roof * (eta_prim +
+								   beta1 * cos(2.0 * xi_prim) * sinh(2.0 * eta_prim) +
+								   beta2 * cos(4.0 * xi_prim) * sinh(4.0 * eta_prim) +
+								   beta3 * cos(6.0 * xi_prim) * sinh(6.0 * eta_prim) +
+								   beta4 * cos(8.0 * xi_prim) * sinh(8.0 * eta_prim)) +
+			   m_false_easting;
+	x_y.x = round(x * 1000.0) / 1000.0;
+	x_y.y = round(y * 1000.0) / 1000.0;
+	return x_y;
+}
+
+// Same series as above, with the derivatives of every step:
+//   latitude -> phi* (conformal latitude) -> (xi', eta') -> (x, y).
+// The grid coordinate is computed exactly as in the plain version.
+VTI_INLINE GaussKreuger::Coordinate GaussKreuger::geodetic_to_grid(const ForwardConstants& constants, double latitude, double longitude, Jacobian& jacobian) const noexcept
+{
+	Coordinate x_y;
+	const double A = constants.A;
+	const double B = constants.B;
+	const double C = constants.C;
+	const double D = constants.D;
+	const double beta1 = constants.beta1;
+	const double beta2 = constants.beta2;
+	const double beta3 = constants.beta3;
+	const double beta4 = constants.beta4;
+	double deg_to_rad = M_PI / 180.0;
+	double phi = latitude * deg_to_rad;
+	double lambda = longitude * deg_to_rad;
+	double lambda_zero = m_central_meridian * deg_to_rad;
+	double sin_phi = sin(phi);
+	double cos_phi = cos(phi);
+	double phi_star = phi - sin(phi) * cos(phi) * (A +
+					  B * pow(sin(phi), 2) +
+					  C * pow(sin(phi), 4) +
+					  D * pow(sin(phi), 6));
+	double delta_lambda = lambda - lambda_zero;
+	double xi_prim = atan(tan(phi_star) / cos(delta_lambda));
+	double eta_prim = atanh(cos(phi_star) * sin(delta_lambda));
+	double sin2 = sin(2.0 * xi_prim), cos2 = cos(2.0 * xi_prim), sinh2 = sinh(2.0 * eta_prim), cosh2 = cosh(2.0 * eta_prim);
+	double sin4 = sin(4.0 * xi_prim), cos4 = cos(4.0 * xi_prim), sinh4 = sinh(4.0 * eta_prim), cosh4 = cosh(4.0 * eta_prim);
+	double sin6 = sin(6.0 * xi_prim), cos6 = cos(6.0 * xi_prim), sinh6 = sinh(6.0 * eta_prim), cosh6 = cosh(6.0 * eta_prim);
+	double sin8 = sin(8.0 * xi_prim), cos8 = cos(8.0 * xi_prim), sinh8 = sinh(8.0 * eta_prim), cosh8 = cosh(8.0 * eta_prim);
+	double k_a = m_scale * constants.a_roof;
+	double x = k_a * (xi_prim +
+					  beta1 * sin2 * cosh2 +
+					  beta2 * sin4 * cosh4 +
+					  beta3 * sin6 * cosh6 +
+					  beta4 * sin8 * cosh8) +
+			   m_false_northing;
+	double y = k_a * (eta_prim +
+					  beta1 * cos2 * sinh2 +
+					  beta2 * cos4 * sinh4 +
+					  beta3 * cos6 * sinh6 +
+					  beta4 * cos8 * sinh8) +
+			   m_false_easting;
+	x_y.x = round(x * 1000.0) / 1000.0;
+	x_y.y = round(y * 1000.0) / 1000.0;
+
+	// d(phi*) / d(phi)
+	double s2 = sin_phi * sin_phi;
+	double dphi_star = 1.0 - cos(2.0 * phi) * (A + B * s2 + C * s2 * s2 + D * s2 * s2 * s2) -
+					   cos_phi * cos_phi * (2.0 * B * s2 + 4.0 * C * s2 * s2 + 6.0 * D * s2 * s2 * s2);
+	// Derivatives of (xi', eta') with respect to phi* and delta lambda.
+	double tan_phi_star = tan(phi_star);
+	double cos_phi_star = cos(phi_star);
+	double sin_delta = sin(delta_lambda);
+	double cos_delta = cos(delta_lambda);
+	double u = tan_phi_star / cos_delta;
+	double v = cos_phi_star * sin_delta;
+	double dxi_dphi = 1.0 / (cos_phi_star * cos_phi_star * cos_delta * (1.0 + u * u));
+	double dxi_dlambda = tan_phi_star * sin_delta / (cos_delta * cos_delta * (1.0 + u * u));
+	double deta_dphi = -sin(phi_star) * sin_delta / (1.0 - v * v);
+	double deta_dlambda = cos_phi_star * cos_delta / (1.0 - v * v);
+	// The series is analytic in xi' + i eta', so dx/dxi' = dy/deta' = p and
+	// dx/deta' = -dy/dxi' = q.
+	double p = 1.0 +
+			   2.0 * beta1 * cos2 * cosh2 +
+			   4.0 * beta2 * cos4 * cosh4 +
+			   6.0 * beta3 * cos6 * cosh6 +
+			   8.0 * beta4 * cos8 * cosh8;
+	double q = 2.0 * beta1 * sin2 * sinh2 +
+			   4.0 * beta2 * sin4 * sinh4 +
+			   6.0 * beta3 * sin6 * sinh6 +
+			   8.0 * beta4 * sin8 * sinh8;
+	double latitude_scale = k_a * dphi_star * deg_to_rad;
+	double longitude_scale = k_a * deg_to_rad;
+	jacobian.dx_dlatitude = latitude_scale * (p * dxi_dphi + q * deta_dphi);
+	jacobian.dx_dlongitude = longitude_scale * (p * dxi_dlambda + q * deta_dlambda);
+	jacobian.dy_dlatitude = latitude_scale * (p * deta_dphi - q * dxi_dphi);
+	jacobian.dy_dlongitude = longitude_scale * (p * deta_dlambda - q * dxi_dlambda);
+	return x_y;
+}
+
+VTI_INLINE GaussKreuger::Covariance GaussKreuger::propagate(const Jacobian& jacobian, const Covariance& covariance) noexcept
+{
+	// J C, then (J C) J^T. Only the upper triangle is kept.
+	double a = jacobian.dx_dlatitude * covariance.xx + jacobian.dx_dlongitude * covariance.xy;
+	double b = jacobian.dx_dlatitude * covariance.xy + jacobian.dx_dlongitude * covariance.yy;
+	double c = jacobian.dy_dlatitude * covariance.xx + jacobian.dy_dlongitude * covariance.xy;
+	double d = jacobian.dy_dlatitude * covariance.xy + jacobian.dy_dlongitude * covariance.yy;
+	Covariance result;
+	result.xx = a * jacobian.dx_dlatitude + b * jacobian.dx_dlongitude;
+	result.xy = a * jacobian.dy_dlatitude + b * jacobian.dy_dlongitude;
+	result.yy = c * jacobian.dy_dlatitude + d * jacobian.dy_dlongitude;
+	return result;
+}
+
+VTI_INLINE GaussKreuger::Covariance GaussKreuger::propagate_inverse(const Jacobian& jacobian, const Covariance& covariance) noexcept
+{
+	double determinant = jacobian.dx_dlatitude * jacobian.dy_dlongitude - jacobian.dx_dlongitude * jacobian.dy_dlatitude;
+	// Rows latitude and longitude, columns x and y.
+	Jacobian inverse;
+	inverse.dx_dlatitude = jacobian.dy_dlongitude / determinant;
+	inverse.dx_dlongitude = -jacobian.dx_dlongitude / determinant;
+	inverse.dy_dlatitude = -jacobian.dy_dlatitude / determinant;
+	inverse.dy_dlongitude = jacobian.dx_dlatitude / determinant;
+	return propagate(inverse, covariance);
+}
+
+VTI_INLINE GaussKreuger::Coordinate GaussKreuger::grid_to_geodetic(const InverseConstants& constants, double x, double y) const noexcept
+{
+	Coordinate lat_lon;
+
+	if (m_central_meridian == std::numeric_limits<double>::min()) {
+		lat_lon.x = 0;
+		lat_lon.y = 0;
+		return lat_lon;
+	}
+
+	const double delta1 = constants.delta1;
+	const double delta2 = constants.delta2;
+	const double delta3 = constants.delta3;
+	const double delta4 = constants.delta4;
+	const double Astar = constants.Astar;
+	const double Bstar = constants.Bstar;
+	const double Cstar = constants.Cstar;
+	const double Dstar = constants.Dstar;
+	// Convert.
+	double deg_to_rad = M_PI / 180;
+	double lambda_zero = m_central_meridian * deg_to_rad;
+	double xi = (x - m_false_northing) / (m_scale * constants.a_roof);
+	double eta = (y - m_false_easting) / (m_scale * constants.a_roof);
+	double xi_prim = xi -
+					 delta1 * sin(2.0 * xi) * cosh(2.0 * eta) -
+					 delta2 * sin(4.0 * xi) * cosh(4.0 * eta) -
+					 delta3 * sin(6.0 * xi) * cosh(6.0 * eta) -
+					 delta4 * sin(8.0 * xi) * cosh(8.0 * eta);
+	double eta_prim = eta -
+					  delta1 * cos(2.0 * xi) * sinh(2.0 * eta) -
+					  delta2 * cos(4.0 * xi) * sinh(4.0 * eta) -
+					  delta3 * cos(6.0 * xi) * sinh(6.0 * eta) -
+					  delta4 * cos(8.0 * xi) * sinh(8.0 * eta);
+	double phi_star = asin(sin(xi_prim) / cosh(eta_prim));
+	double delta_lambda = atan(sinh(eta_prim) / cos(xi_prim));
+	double lon_radian = lambda_zero + delta_lambda;
+	double lat_radian = phi_star + sin(phi_star) * cos(phi_star) *
+						(Astar +
+						 Bstar * pow(sin(phi_star), 2) +
+						 Cstar * pow(sin(phi_star), 4) +
+						 Dstar * pow(sin(phi_star), 6));
+	lat_lon.x = lat_radian * 180.0 / M_PI;
+	lat_lon.y = lon_radian * 180.0 / M_PI;
+	return lat_lon;
+}
+
+} // namespace vti
+
+#endif // _COORDINATE_GAUSSKREUGER_INL_
@@ -0,0 +1,66 @@
+/*
+ * geocentric.h
+ *
+ *  Created on: October 19, 2026
+ *      Author: Bjorn Blissing
+ */
+
+#ifndef _COORDINATE_GEOCENTRIC_H_
+#define _COORDINATE_GEOCENTRIC_H_ 1
+
+#include "ellipsoid.h"
+
+#include <cstddef>
+
+namespace vti {
+
+	// Conversion between geodetic coordinates and Earth-centred, Earth-fixed
+	// (ECEF) cartesian coordinates on a given ellipsoid.
+	class Geocentric {
+	public:
+		struct Geodetic {
+			Geodetic() : latitude(0.0), longitude(0.0), height(0.0) {}
+			Geodetic(double lat, double lon, double h) : latitude(lat), longitude(lon), height(h) {}
+			double latitude; // Degrees.
+			double longitude; // Degrees.
+			double height; // Metres above the ellipsoid.
+		};
+
+		struct Cartesian {
+			Cartesian() : x(0.0), y(0.0), z(0.0) {}
+			Cartesian(double cx, double cy, double cz) : x(cx), y(cy), z(cz) {}
+			double x;
+			double y;
+			double z;
+		};
+
+		explicit Geocentric(const Ellipsoid& ellipsoid = Ellipsoid::grs80());
+
+		// Conversion from geodetic coordinates to geocentric coordinates.
+		Cartesian geodetic_to_geocentric(double latitude, double longitude, double height = 0.0) const;
+		// Conversion from geocentric coordinates to geodetic coordinates.
+		// Closed form solution (Heikkinen), exact for all points outside the
+		// core of the earth.
+		Geodetic geocentric_to_geodetic(const Cartesian& geocentric) const;
+		// Batch versions. Input and output may not overlap.
+		void geodetic_to_geocentric(const Geodetic* geodetic, Cartesian* geocentric, size_t count) const;
+		void geocentric_to_geodetic(const Cartesian* geocentric, Geodetic* geodetic, size_t count) const;
+		// Batch versions on separate arrays per component. The loops are free of
+		// branches, so the compiler can vectorize them where vector versions of
+		// the math functions are available.
+		void geodetic_to_geocentric(const double* latitude, const double* longitude, const double* height,
+									double* x, double* y, double* z, size_t count) const;
+		void geocentric_to_geodetic(const double* x, const double* y, const double* z,
+									double* latitude, double* longitude, double* height, size_t count) const;
+
+		const Ellipsoid& ellipsoid() const { return m_ellipsoid; }
+	protected:
+		Ellipsoid m_ellipsoid;
+		double m_b; // Semi-minor axis.
+		double m_e2; // First eccentricity squared.
+		double m_ep2; // Second eccentricity squared.
+	};
+
+} // namespace vti
+
+#endif // _COORDINATE_GEOCENTRIC_H_
@@ -0,0 +1,78 @@
+/*
+ * geodesic.h
+ *
+ *  Created on: October 19, 2026
+ *      Author: Bjorn Blissing
+ */
+
+#ifndef _COORDINATE_GEODESIC_H_
+#define _COORDINATE_GEODESIC_H_ 1
+
+#include "ellipsoid.h"
+#include "gausskreuger.h"
+
+#include <cstddef>
+
+namespace vti {
+
+	// Geodesic distances and azimuths on an ellipsoid, using Vincenty's
+	// formulae. Positions are geodetic coordinates in degrees, latitude in x
+	// and longitude in y. Azimuths are in degrees clockwise from north in the
+	// range [0, 360).
+	class Geodesic {
+	public:
+		struct InverseResult {
+			InverseResult() : distance(0.0), forward_azimuth(0.0), back_azimuth(0.0), converged(true) {}
+			double distance; // Metres.
+			double forward_azimuth; // Azimuth at the first point towards the second.
+			double back_azimuth; // Azimuth at the second point towards the first.
+			bool converged; // False for nearly antipodal points where the iteration fails.
+		};
+
+		struct DirectResult {
+			DirectResult() : latitude(0.0), longitude(0.0), azimuth(0.0) {}
+			double latitude;
+			double longitude;
+			double azimuth; // Forward azimuth at the end point.
+		};
+
+		explicit Geodesic(const Ellipsoid& ellipsoid = Ellipsoid::grs80());
+
+		// Distance and azimuths between two points.
+		InverseResult inverse(double latitude1, double longitude1, double latitude2, double longitude2) const;
+		// Point reached by travelling the distance (metres) along the azimuth.
+		DirectResult direct(double latitude, double longitude, double azimuth, double distance) const;
+
+		// Batch versions over pairs of points.
+		void inverse(const GaussKreuger::Coordinate* from, const GaussKreuger::Coordinate* to, InverseResult* results, size_t count) const;
+		void direct(const GaussKreuger::Coordinate* from, const double* azimuths, const double* distances, DirectResult* results, size_t count) const;
+
+		// Distances in metres between all origins and destinations, written
+		// row by row: distances[i * destinationCount + j]. The trigonometry
+		// of each point is computed once, not once per pair. Pairs where the
+		// inverse solution does not converge, i.e. nearly antipodal points,
+		// get NaN. Returns the number of such pairs.
+		size_t distance_matrix(const GaussKreuger::Coordinate* origins, size_t originCount,
+							   const GaussKreuger::Coordinate* destinations, size_t destinationCount, double* distances) const;
+		// Symmetric distance matrix between all points (count * count values).
+		// Only half of the pairs are evaluated. Returns the number of point
+		// pairs that did not converge, each of which is NaN in both places.
+		size_t distance_matrix(const GaussKreuger::Coordinate* points, size_t count, double* distances) const;
+	protected:
+		// Per point values used by the inverse solution.
+		struct Reduced {
+			double sin_u;
+			double cos_u;
+			double lambda; // Longitude in radians.
+		};
+
+		Reduced reduce(double latitude, double longitude) const;
+		InverseResult inverse(const Reduced& first, const Reduced& second, bool azimuths) const;
+
+		Ellipsoid m_ellipsoid;
+		double m_b; // Semi-minor axis.
+	};
+
+} // namespace vti
+
+#endif // _COORDINATE_GEODESIC_H_
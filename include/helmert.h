@@ -0,0 +1,68 @@
+/*
+ * helmert.h
+ *
+ *  Created on: October 19, 2026
+ *      Author: Bjorn Blissing
+ */
+
+#ifndef _COORDINATE_HELMERT_H_
+#define _COORDINATE_HELMERT_H_ 1
+
+#include "ellipsoid.h"
+#include "geocentric.h"
+
+#include <cstddef>
+
+namespace vti {
+
+	// Seven parameter Helmert datum transform. Geodetic coordinates on the
+	// source ellipsoid are converted to geocentric coordinates, transformed,
+	// and converted back to geodetic coordinates on the target ellipsoid.
+	//
+	// Used to convert coordinates from old maps given as latitude and
+	// longitude on Bessel 1841 (see the bessel_rt90_* projections in
+	// GaussKreuger) to SWEREF 99 / WGS 84, and back.
+	class Helmert {
+	public:
+		// Parameters in the position vector convention.
+		struct Parameters {
+			Parameters() : tx(0.0), ty(0.0), tz(0.0), rx(0.0), ry(0.0), rz(0.0), scale(0.0) {}
+			double tx, ty, tz; // Translation, metres.
+			double rx, ry, rz; // Rotation, arc seconds.
+			double scale; // Scale correction, ppm.
+		};
+
+		Helmert(const Ellipsoid& source, const Ellipsoid& target, const Parameters& parameters);
+
+		// RT 90 on Bessel 1841 to SWEREF 99 on GRS 80, with the parameters
+		// published by Lantmateriet.
+		static Helmert rt90_to_sweref99();
+		// The exact inverse transform, from target to source.
+		Helmert inverse() const;
+
+		// Transform geocentric coordinates.
+		Geocentric::Cartesian transform(const Geocentric::Cartesian& geocentric) const;
+		// Transform geodetic coordinates.
+		Geocentric::Geodetic transform(double latitude, double longitude, double height = 0.0) const;
+		// Batch version. Input and output may refer to the same array.
+		void transform(const Geocentric::Geodetic* source, Geocentric::Geodetic* target, size_t count) const;
+		// Batch version on separate arrays per component, suited for
+		// vectorization. Heights may be null, in which case input heights are
+		// zero and output heights are discarded. Input and output arrays may be the same.
+		void transform(const double* latitude, const double* longitude, const double* height,
+					   double* targetLatitude, double* targetLongitude, double* targetHeight, size_t count) const;
+
+		const Geocentric& source() const { return m_source; }
+		const Geocentric& target() const { return m_target; }
+	protected:
+		Helmert(const Geocentric& source, const Geocentric& target) : m_source(source), m_target(target) {}
+
+		Geocentric m_source;
+		Geocentric m_target;
+		double m_matrix[9]; // Row major rotation including scale.
+		double m_translation[3];
+	};
+
+} // namespace vti
+
+#endif // _COORDINATE_HELMERT_H_
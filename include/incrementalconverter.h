@@ -0,0 +1,84 @@
+/*
+ * incrementalconverter.h
+ *
+ *  Created on: October 19, 2026
+ *      Author: Bjorn Blissing
+ */
+
+#ifndef _COORDINATE_INCREMENTALCONVERTER_H_
+#define _COORDINATE_INCREMENTALCONVERTER_H_ 1
+
+#include "gausskreuger.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace vti {
+
+	// Bulk conversion that only reconverts the parts of a dataset that changed
+	// since the previous run.
+	//
+	// The input is split into blocks with content defined boundaries: a block
+	// ends after a record whose hash hits a fixed pattern. Inserting or
+	// removing records therefore only changes the blocks around the edit, not
+	// every block after it. Each block is identified by a 64-bit FNV-1a hash of
+	// its records, and the cache maps block hashes to converted output. The
+	// cache is saved to a file together with the projection parameters and
+	// direction, and is ignored on load if either differs.
+	//
+	// Typical use in a recurring job:
+	//	IncrementalConverter converter(projection, IncrementalConverter::Direction::GridToGeodetic);
+	//	converter.load(cachePath);
+	//	converter.convert(&input[0], &output[0], input.size());
+	//	converter.save(cachePath);
+	class IncrementalConverter {
+	public:
+		enum class Direction { GeodeticToGrid, GridToGeodetic };
+
+		// blockSize is the average number of records per block. Blocks are at
+		// least a quarter and at most four times this size.
+		IncrementalConverter(const GaussKreuger& projection, Direction direction, size_t blockSize = 4096);
+
+		// Convert count coordinates, geodetic with latitude in x and longitude
+		// in y. Blocks found in the cache are copied, the others are
+		// converted. Afterwards the cache holds exactly the blocks of this
+		// input. Input and output may refer to the same array.
+		void convert(const GaussKreuger::Coordinate* input, GaussKreuger::Coordinate* output, size_t count);
+
+		// Replace the cache with the one stored in path. Returns false, and
+		// leaves the cache empty, if the file is missing, damaged or was
+		// written for another projection, direction or block size.
+		bool load(const std::string& path);
+		// Store the cache in path. Returns false on failure.
+		bool save(const std::string& path) const;
+
+		// Number of blocks in the last convert.
+		size_t blocks() const { return m_blocks; }
+		// Number of blocks in the last convert that were not in the cache.
+		size_t reconverted() const { return m_reconverted; }
+	protected:
+		struct Block {
+			size_t count;
+			size_t offset; // Into m_output.
+		};
+
+		typedef std::unordered_map<uint64_t, Block> BlockMap;
+
+		void convert_block(const GaussKreuger::Coordinate* input, GaussKreuger::Coordinate* output, size_t count) const;
+
+		GaussKreuger m_projection;
+		Direction m_direction;
+		size_t m_block_size;
+		uint64_t m_parameters; // Hash of the projection parameters and direction.
+		BlockMap m_cache;
+		std::vector<GaussKreuger::Coordinate> m_output; // Converted blocks, back to back.
+		size_t m_blocks;
+		size_t m_reconverted;
+	};
+
+} // namespace vti
+
+#endif // _COORDINATE_INCREMENTALCONVERTER_H_
@@ -0,0 +1,83 @@
+/*
+ * lazyposition.h
+ *
+ *  Created on: October 19, 2026
+ *      Author: Bjorn Blissing
+ */
+
+#ifndef _COORDINATE_LAZYPOSITION_H_
+#define _COORDINATE_LAZYPOSITION_H_ 1
+
+#include "rt90position.h"
+#include "sweref99position.h"
+
+namespace vti {
+
+	/**
+	* A position that keeps its source coordinates and projection and converts
+	* to other representations only when they are first requested. Converted
+	* representations are cached, so repeated reads are free.
+	*
+	* The source coordinates are kept unchanged and returned as they are when
+	* the source representation is requested. Of the other representations,
+	* WGS84 and SWEREF 99 TM are always cached once computed. One additional
+	* SWEREF 99 zone and one RT90 zone are cached, the most recently requested
+	* of each.
+	*
+	* The cache is updated from const accessors, so a LazyPosition must not be
+	* read from several threads at the same time without external locking.
+	*/
+	class LazyPosition {
+	public:
+		explicit LazyPosition(const WGS84Position& position);
+		explicit LazyPosition(const RT90Position& position);
+		explicit LazyPosition(const SWEREF99Position& position);
+
+		/**
+		* Grid of the coordinates this position was created from
+		*/
+		Position::Grid getSourceGrid() const { return m_sourceGrid; }
+
+		/**
+		* Get the position in WGS84 format
+		*/
+		WGS84Position toWGS84() const;
+
+		/**
+		* Get the position in SWEREF 99 TM
+		*/
+		SWEREF99Position toSWEREF99() const;
+
+		/**
+		* Get the position in the given SWEREF 99 projection, e.g. a local zone
+		*/
+		SWEREF99Position toSWEREF99(SWEREF99Position::SWEREFProjection projection) const;
+
+		/**
+		* Get the position in the given RT90 projection
+		*/
+		RT90Position toRT90(RT90Position::RT90Projection projection = RT90Position::RT90Projection::rt90_2_5_gon_v) const;
+
+	protected:
+		struct Cached {
+			Cached() : valid(false), projection(0), x(0.0), y(0.0) {}
+			Cached(int proj, double first, double second) : valid(true), projection(proj), x(first), y(second) {}
+			bool valid;
+			int projection;
+			double x;
+			double y;
+		};
+
+		void toGrid(const char* projectionName, Cached& cache, int projection) const;
+
+		Position::Grid m_sourceGrid;
+		const Cached m_source; // Never changed, the slots below only hold derived values.
+		mutable Cached m_wgs84;
+		mutable Cached m_swerefTM;
+		mutable Cached m_sweref;
+		mutable Cached m_rt90;
+	};
+
+} // namespace vti
+
+#endif // _COORDINATE_LAZYPOSITION_H_
@@ -0,0 +1,54 @@
+/*
+ * localtangentplane.h
+ *
+ *  Created on: October 19, 2026
+ *      Author: Bjorn Blissing
+ */
+
+#ifndef _COORDINATE_LOCALTANGENTPLANE_H_
+#define _COORDINATE_LOCALTANGENTPLANE_H_ 1
+
+#include "gausskreuger.h"
+#include "geocentric.h"
+
+#include <cstddef>
+
+namespace vti {
+
+	// Local East-North-Up frame tangent to the ellipsoid at a fixed origin.
+	// The origin and its rotation are computed once at construction, so
+	// converting a point only costs a translation and a 3x3 rotation on top
+	// of the geodetic/geocentric conversion.
+	// East is returned in x, north in y and up in z, all in metres.
+	class LocalTangentPlane {
+	public:
+		LocalTangentPlane(double latitude, double longitude, double height = 0.0, const Ellipsoid& ellipsoid = Ellipsoid::grs80());
+
+		Geocentric::Cartesian geocentric_to_enu(const Geocentric::Cartesian& geocentric) const;
+		Geocentric::Cartesian enu_to_geocentric(const Geocentric::Cartesian& enu) const;
+		Geocentric::Cartesian geodetic_to_enu(double latitude, double longitude, double height = 0.0) const;
+		Geocentric::Geodetic enu_to_geodetic(const Geocentric::Cartesian& enu) const;
+
+		// Batch versions. Input and output may not overlap.
+		void geocentric_to_enu(const Geocentric::Cartesian* geocentric, Geocentric::Cartesian* enu, size_t count) const;
+		void enu_to_geocentric(const Geocentric::Cartesian* enu, Geocentric::Cartesian* geocentric, size_t count) const;
+		void geodetic_to_enu(const Geocentric::Geodetic* geodetic, Geocentric::Cartesian* enu, size_t count) const;
+		void enu_to_geodetic(const Geocentric::Cartesian* enu, Geocentric::Geodetic* geodetic, size_t count) const;
+
+		// Conversion from grid coordinates (e.g. SWEREF 99 TM) of the given
+		// projection. Heights are optional and default to zero.
+		void grid_to_enu(const GaussKreuger& projection, const GaussKreuger::Coordinate* grid, const double* heights, Geocentric::Cartesian* enu, size_t count) const;
+		// Conversion to grid coordinates of the given projection. Heights are
+		// written to heights unless it is null.
+		void enu_to_grid(const GaussKreuger& projection, const Geocentric::Cartesian* enu, GaussKreuger::Coordinate* grid, double* heights, size_t count) const;
+
+		const Geocentric::Cartesian& origin() const { return m_origin; }
+	protected:
+		Geocentric m_geocentric;
+		Geocentric::Cartesian m_origin; // Origin in geocentric coordinates.
+		double m_rotation[3][3]; // Rows are the east, north and up unit vectors.
+	};
+
+} // namespace vti
+
+#endif // _COORDINATE_LOCALTANGENTPLANE_H_
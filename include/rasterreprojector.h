@@ -0,0 +1,87 @@
+/*
+ * rasterreprojector.h
+ *
+ *  Created on: October 19, 2026
+ *      Author: Bjorn Blissing
+ */
+
+#ifndef _COORDINATE_RASTERREPROJECTOR_H_
+#define _COORDINATE_RASTERREPROJECTOR_H_ 1
+
+#include "gausskreuger.h"
+
+#include <cstddef>
+
+namespace vti {
+
+	// Definition of a north-up raster. Coordinates follow the convention of
+	// GaussKreuger: x is northing (or latitude) and y is easting (or longitude).
+	// The origin is the north-west corner of the raster, rows run south and
+	// columns run east.
+	struct RasterGrid {
+		RasterGrid() : origin_x(0.0), origin_y(0.0), pixel_size_x(1.0), pixel_size_y(1.0), rows(0), columns(0) {}
+		RasterGrid(double originX, double originY, double pixelSizeX, double pixelSizeY, size_t rowCount, size_t columnCount) :
+			origin_x(originX), origin_y(originY), pixel_size_x(pixelSizeX), pixel_size_y(pixelSizeY), rows(rowCount), columns(columnCount) {}
+
+		// Centre of the given pixel.
+		GaussKreuger::Coordinate pixel_centre(size_t row, size_t column) const
+		{
+			GaussKreuger::Coordinate centre;
+			centre.x = origin_x - (row + 0.5) * pixel_size_x;
+			centre.y = origin_y + (column + 0.5) * pixel_size_y;
+			return centre;
+		}
+
+		double origin_x;
+		double origin_y;
+		double pixel_size_x;
+		double pixel_size_y;
+		size_t rows;
+		size_t columns;
+	};
+
+	// Computes, for every pixel centre of an output raster, the corresponding
+	// coordinate in the source coordinate system. This is the coordinate a
+	// resampler needs to look up in the source raster.
+	//
+	// A projection pointer that is null means geodetic WGS84 coordinates
+	// (latitude in x, longitude in y, in degrees).
+	//
+	// The raster is processed in square tiles. For each tile the transformation
+	// is evaluated exactly at the corners and checked at the centre and edge
+	// midpoints against bilinear interpolation. Tiles that interpolate within
+	// the tolerance are filled by interpolation, others are split in four
+	// until they do, or are small enough to evaluate every pixel exactly.
+	// The tolerance is given in source coordinate units.
+	class RasterReprojector {
+	public:
+		RasterReprojector(const RasterGrid& output, const GaussKreuger* outputProjection, const GaussKreuger* sourceProjection,
+						  double tolerance, size_t tileSize = 64);
+
+		const RasterGrid& output() const { return m_output; }
+
+		// Exact transformation of a single output coordinate to the source system.
+		GaussKreuger::Coordinate transform(const GaussKreuger::Coordinate& output) const;
+
+		// Compute source coordinates for rows [rowBegin, rowEnd). The result is
+		// written to out, which holds rows * columns coordinates for the whole
+		// raster in row-major order. Row bands can be processed in parallel.
+		// Returns the number of exact evaluations.
+		size_t compute_rows(size_t rowBegin, size_t rowEnd, GaussKreuger::Coordinate* out) const;
+		// Compute source coordinates for the whole raster, split in row bands
+		// over the given number of threads. Returns the number of exact evaluations.
+		size_t compute(GaussKreuger::Coordinate* out, unsigned threads = 1) const;
+	protected:
+		size_t process_tile(size_t rowBegin, size_t columnBegin, size_t rowEnd, size_t columnEnd, GaussKreuger::Coordinate* out) const;
+		GaussKreuger::Coordinate transform_pixel(size_t row, size_t column) const;
+
+		RasterGrid m_output;
+		const GaussKreuger* m_outputProjection;
+		const GaussKreuger* m_sourceProjection;
+		double m_tolerance;
+		size_t m_tileSize;
+	};
+
+} // namespace vti
+
+#endif // _COORDINATE_RASTERREPROJECTOR_H_
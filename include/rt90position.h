@@ -36,22 +36,33 @@ namespace vti {
 		/**
 		* Create a RT90 position by converting a WGS84 position
 		*/
-		RT90Position(WGS84Position position, RT90Projection rt90projection);
+		RT90Position(WGS84Position position, RT90Projection rt90projection) noexcept;
 
 		/**
 		* Convert position to WGS84 format
 		*/
-		WGS84Position toWGS84();
+		WGS84Position toWGS84() const noexcept;
 
 		/**
 		* Get projection type as String
 		* @return
 		*/
-		std::string getProjectionString()
+		std::string getProjectionString() const
 		{
 			return getProjectionString(m_projection);
 		}
 
+		/**
+		* Get projection type
+		*/
+		RT90Projection getProjection() const { return m_projection; }
+
+		/**
+		* Get projection name as used by GaussKreuger::swedish_params.
+		* Does not allocate and is safe to call from real-time code.
+		*/
+		static const char* getProjectionName(RT90Projection projection) noexcept;
+
 	protected:
 		static std::string getProjectionString(RT90Projection projection);
 		RT90Projection m_projection;
@@ -0,0 +1,97 @@
+/*
+ * spatialindex.h
+ *
+ *  Created on: October 19, 2026
+ *      Author: Bjorn Blissing
+ */
+
+#ifndef _COORDINATE_SPATIALINDEX_H_
+#define _COORDINATE_SPATIALINDEX_H_ 1
+
+#include "gausskreuger.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace vti {
+
+	// Static k-d tree over grid coordinates of one projection, e.g. SWEREF 99 TM,
+	// built in bulk and stored packed in a single array.
+	//
+	// Queries are given as WGS84 coordinates (latitude, longitude) and are
+	// projected once. Distances are distances on the ellipsoid, approximated
+	// as grid distance divided by the point scale factor at the midpoint
+	// between the query and each candidate. The scale factor changes by up to
+	// about 1e-5 per kilometre near the edge of a wide zone such as SWEREF 99
+	// TM, so a single scale factor for the whole query would be off by
+	// centimetres to decimetres at a few kilometres. Around each query the
+	// scale factor is modelled as a quadratic in easting, from the exact
+	// scale factor at the query and 1 km east and west of it. Its change
+	// with northing is a few orders of magnitude smaller and is ignored.
+	// Distances are good to about a millimetre up to 10 km.
+	class SpatialIndex {
+	public:
+		struct Neighbour {
+			Neighbour() : index(0), distance(0.0) {}
+			Neighbour(size_t i, double d) : index(i), distance(d) {}
+			size_t index; // Index of the point in the input to the constructor.
+			double distance; // Metres.
+		};
+
+		// Build the index from grid coordinates of the given projection.
+		SpatialIndex(const GaussKreuger& projection, const GaussKreuger::Coordinate* grid, size_t count);
+		// Build the index from geodetic coordinates (latitude in x, longitude in y),
+		// which are projected in one batch.
+		static SpatialIndex from_geodetic(const GaussKreuger& projection, const GaussKreuger::Coordinate* geodetic, size_t count);
+
+		size_t size() const { return m_nodes.size(); }
+
+		// All points within radius metres of the query point, nearest first.
+		void radius_search(double latitude, double longitude, double radius, std::vector<Neighbour>& result) const;
+		// The k nearest points, nearest first.
+		void nearest(double latitude, double longitude, size_t k, std::vector<Neighbour>& result) const;
+
+		// Same as above for a query point already given in grid coordinates.
+		// Distances are grid distances divided by the constant scale.
+		void radius_search_grid(const GaussKreuger::Coordinate& grid, double radius, double scale, std::vector<Neighbour>& result) const;
+		void nearest_grid(const GaussKreuger::Coordinate& grid, size_t k, double scale, std::vector<Neighbour>& result) const;
+	protected:
+		struct Node {
+			GaussKreuger::Coordinate point;
+			size_t index;
+		};
+
+		// Point scale factor around a query as a quadratic in the easting
+		// offset from the query.
+		struct ScaleModel {
+			double easting; // Of the query.
+			double scale; // At the query.
+			double slope; // Per metre of easting.
+			double curvature; // Second derivative, per square metre.
+
+			// Scale factor at the midpoint between the query and a point at easting y.
+			double midpoint(double y) const
+			{
+				double t = (y - easting) / 2.0;
+				return scale + slope * t + 0.5 * curvature * t * t;
+			}
+			// Smallest and largest midpoint scale for points within a grid distance.
+			void range(double distance, double& minimum, double& maximum) const;
+		};
+
+		ScaleModel scale_model(double latitude, double longitude, const GaussKreuger::Coordinate& grid) const;
+		void radius_search(const GaussKreuger::Coordinate& grid, double radius, const ScaleModel& model, std::vector<Neighbour>& result) const;
+		void nearest(const GaussKreuger::Coordinate& grid, size_t k, const ScaleModel& model, std::vector<Neighbour>& result) const;
+
+		void build(size_t begin, size_t end, int axis);
+		void radius_search(size_t begin, size_t end, int axis, const GaussKreuger::Coordinate& query, double radius2,
+						   const ScaleModel& model, double radius, std::vector<Neighbour>& result) const;
+		void nearest(size_t begin, size_t end, int axis, const GaussKreuger::Coordinate& query, size_t k, std::vector<Neighbour>& heap) const;
+
+		GaussKreuger m_projection;
+		std::vector<Node> m_nodes; // Implicit tree, the median of each range is its root.
+	};
+
+} // namespace vti
+
+#endif // _COORDINATE_SPATIALINDEX_H_
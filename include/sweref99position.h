@@ -43,21 +43,32 @@ class SWEREF99Position : public Position {
 		/**
 		* Create a SWEREF99 position by converting a WGS84 position
 		*/
-		SWEREF99Position(WGS84Position position, SWEREFProjection projection);
+		SWEREF99Position(WGS84Position position, SWEREFProjection projection) noexcept;
 
 		/**
 		* Convert the position to WGS84 format
 		*/
-		WGS84Position toWGS84();
+		WGS84Position toWGS84() const noexcept;
 
 		/**
 		* Get projection type as String
 		*/
-		std::string getProjectionString()
+		std::string getProjectionString() const
 		{
 			return getProjectionString(m_projection);
 		}
 
+		/**
+		* Get projection type
+		*/
+		SWEREFProjection getProjection() const { return m_projection; }
+
+		/**
+		* Get projection name as used by GaussKreuger::swedish_params.
+		* Does not allocate and is safe to call from real-time code.
+		*/
+		static const char* getProjectionName(SWEREFProjection projection) noexcept;
+
 	protected:
 		static std::string getProjectionString(SWEREFProjection projection);
 		SWEREFProjection m_projection;
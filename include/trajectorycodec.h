@@ -0,0 +1,65 @@
+/*
+ * trajectorycodec.h
+ *
+ *  Created on: October 19, 2026
+ *      Author: Bjorn Blissing
+ */
+
+#ifndef _COORDINATE_TRAJECTORYCODEC_H_
+#define _COORDINATE_TRAJECTORYCODEC_H_ 1
+
+#include "gausskreuger.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace vti {
+
+	// Compressed storage for sequences of grid coordinates, e.g. trajectories
+	// in SWEREF 99 TM. Coordinates are stored with the millimetre precision
+	// produced by GaussKreuger::geodetic_to_grid as zig-zag varint deltas.
+	// The sequence is split into blocks that can be decoded independently,
+	// each block starting with an absolute coordinate.
+	//
+	// Serialized layout (all integers are unsigned LEB128 varints):
+	//   count, block size, byte length of each block, block payloads.
+	class TrajectoryCodec {
+	public:
+		TrajectoryCodec() : m_count(0), m_block_size(0) {}
+
+		// Encode grid coordinates. Any previous content is replaced.
+		void encode(const GaussKreuger::Coordinate* coordinates, size_t count, size_t block_size = 256);
+		void encode(const std::vector<GaussKreuger::Coordinate>& coordinates, size_t block_size = 256);
+		// Restore a serialized trajectory. Every block is checked, so the
+		// decode functions can not fail afterwards. Returns false if the data
+		// is malformed, in which case the codec is left empty.
+		bool load(const unsigned char* data, size_t size);
+		// Serialized representation, suitable for writing to disk.
+		const std::vector<unsigned char>& data() const { return m_data; }
+
+		// Number of coordinates in the trajectory.
+		size_t size() const { return m_count; }
+		// Number of coordinates per block (the last block may be shorter).
+		size_t block_size() const { return m_block_size; }
+		size_t block_count() const { return m_offsets.empty() ? 0 : m_offsets.size() - 1; }
+
+		// Decode one block into out, which must hold at least block_size() coordinates.
+		// Returns the number of coordinates written, or 0 if the block does not
+		// exist or is truncated.
+		size_t decode_block(size_t block, GaussKreuger::Coordinate* out) const;
+		// Decode one block and convert it to geodetic coordinates (latitude in x,
+		// longitude in y) using the given projection.
+		size_t decode_block_to_geodetic(size_t block, const GaussKreuger& projection, GaussKreuger::Coordinate* out) const;
+		// Decode the whole trajectory. Empty if any block is truncated.
+		std::vector<GaussKreuger::Coordinate> decode() const;
+		std::vector<GaussKreuger::Coordinate> decode_to_geodetic(const GaussKreuger& projection) const;
+	protected:
+		size_t m_count;
+		size_t m_block_size;
+		std::vector<unsigned char> m_data;
+		std::vector<size_t> m_offsets; // Byte offset of each block in m_data, plus end offset.
+	};
+
+} // namespace vti
+
+#endif // _COORDINATE_TRAJECTORYCODEC_H_
@@ -0,0 +1,56 @@
+/*
+ * trajectorysimplifier.h
+ *
+ *  Created on: October 19, 2026
+ *      Author: Bjorn Blissing
+ */
+
+#ifndef _COORDINATE_TRAJECTORYSIMPLIFIER_H_
+#define _COORDINATE_TRAJECTORYSIMPLIFIER_H_ 1
+
+#include "gausskreuger.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace vti {
+
+	// Douglas-Peucker simplification of WGS84 polylines against a tolerance in
+	// grid metres, fused with the projection to the grid.
+	//
+	// Points are not projected up front. The track is split into blocks short
+	// enough that an affine approximation of the projection, from a finite
+	// difference Jacobian at the first point of the block, is accurate to a
+	// known bound. Each Douglas-Peucker step works on the approximations and
+	// only projects the points whose keep or drop decision the bound leaves
+	// open. The result is the same as simplifying the fully projected track.
+	class TrajectorySimplifier {
+	public:
+		explicit TrajectorySimplifier(const GaussKreuger& projection) : m_projection(projection), m_projections(0) {}
+
+		// Simplify a polyline of geodetic coordinates (latitude in x, longitude
+		// in y). The grid coordinates of the retained vertices are written to
+		// grid, and their indices in the input to indices if given. The first
+		// and last points are always retained.
+		void simplify(const GaussKreuger::Coordinate* geodetic, size_t count, double tolerance,
+					  std::vector<GaussKreuger::Coordinate>& grid, std::vector<size_t>* indices = nullptr);
+
+		// Number of calls to GaussKreuger::geodetic_to_grid in the last simplify,
+		// including the ones for the Jacobians.
+		size_t projections() const { return m_projections; }
+	protected:
+		const GaussKreuger::Coordinate& exact(const GaussKreuger::Coordinate* geodetic, size_t index);
+		void approximate(const GaussKreuger::Coordinate* geodetic, size_t count, double tolerance);
+
+		GaussKreuger m_projection;
+		size_t m_projections;
+		std::vector<GaussKreuger::Coordinate> m_exact; // Projected points, valid where m_projected is set.
+		std::vector<unsigned char> m_projected;
+		std::vector<GaussKreuger::Coordinate> m_approximate;
+		std::vector<double> m_bound; // Bound on the distance between approximate and exact, metres.
+		std::vector<unsigned char> m_keep;
+	};
+
+} // namespace vti
+
+#endif // _COORDINATE_TRAJECTORYSIMPLIFIER_H_
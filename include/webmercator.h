@@ -0,0 +1,66 @@
+/*
+ * webmercator.h
+ *
+ *  Created on: October 19, 2026
+ *      Author: Bjorn Blissing
+ */
+
+#ifndef _COORDINATE_WEBMERCATOR_H_
+#define _COORDINATE_WEBMERCATOR_H_ 1
+
+#include "gausskreuger.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace vti {
+
+	// Web Mercator (EPSG:3857) and XYZ slippy-map tile indices.
+	// Projected coordinates follow the convention of GaussKreuger: x is
+	// northing and y is easting, in metres. Latitudes are clamped to the
+	// square extent of the projection (about 85.05 degrees), and zoom levels
+	// to max_zoom.
+	class WebMercator {
+	public:
+		// Deepest zoom level. Tile indices fit in 32 bits and quadkeys in 64.
+		static const uint32_t max_zoom = 30;
+
+		struct TileKey {
+			TileKey() : x(0), y(0), zoom(0) {}
+			TileKey(uint32_t column, uint32_t row, uint32_t level) : x(column), y(row), zoom(level) {}
+			uint32_t x; // Column, counted from the west.
+			uint32_t y; // Row, counted from the north.
+			uint32_t zoom;
+		};
+
+		// Conversion from geodetic coordinates to Web Mercator.
+		static GaussKreuger::Coordinate geodetic_to_mercator(double latitude, double longitude);
+		// Conversion from Web Mercator to geodetic coordinates.
+		static GaussKreuger::Coordinate mercator_to_geodetic(double x, double y);
+		// Tile containing the given geodetic coordinate.
+		static TileKey geodetic_to_tile(double latitude, double longitude, uint32_t zoom);
+
+		// Batch versions. Input and output may refer to the same array.
+		static void geodetic_to_mercator(const GaussKreuger::Coordinate* geodetic, GaussKreuger::Coordinate* mercator, size_t count);
+		static void mercator_to_geodetic(const GaussKreuger::Coordinate* mercator, GaussKreuger::Coordinate* geodetic, size_t count);
+		static void geodetic_to_tile(const GaussKreuger::Coordinate* geodetic, TileKey* tiles, size_t count, uint32_t zoom);
+
+		// Fused conversions directly from grid coordinates of a projection,
+		// e.g. RT90 or SWEREF 99, without intermediate position objects.
+		static void grid_to_mercator(const GaussKreuger& projection, const GaussKreuger::Coordinate* grid, GaussKreuger::Coordinate* mercator, size_t count);
+		static void grid_to_tile(const GaussKreuger& projection, const GaussKreuger::Coordinate* grid, TileKey* tiles, size_t count, uint32_t zoom);
+		static void grid_to_quadkey(const GaussKreuger& projection, const GaussKreuger::Coordinate* grid, uint64_t* quadkeys, size_t count, uint32_t zoom);
+
+		// Quadkey as an integer with two bits per level, most significant
+		// level first. Together with the zoom level it identifies the tile.
+		static uint64_t quadkey(const TileKey& tile);
+		// Quadkey in the usual string form, e.g. "213" for tile 3, 5 at zoom 3.
+		static std::string quadkey_string(const TileKey& tile);
+		// Tile from an integer quadkey.
+		static TileKey quadkey_to_tile(uint64_t quadkey, uint32_t zoom);
+	};
+
+} // namespace vti
+
+#endif // _COORDINATE_WEBMERCATOR_H_
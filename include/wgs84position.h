@@ -44,6 +44,24 @@ class WGS84Position : public Position {
 		* Returns a string representation in the given format
 		*/
 		std::string longitudeToString(WGS84Format format);
+		/**
+		* Parse a string containing both latitude and longitude. Unlike the string
+		* constructor this never allocates memory or writes to any stream, and
+		* is safe to call from real-time code. Returns false if the string could
+		* not be parsed, in which case position is left unchanged. Hemisphere
+		* letters other than N/S and E/W, signs within the fields, fractional
+		* degrees, minutes or seconds of 60 or more, and anything after the
+		* last field are rejected in the degrees and minutes formats.
+		*/
+		static bool parse(const char* positionString, WGS84Format format, WGS84Position& position) noexcept;
+		/**
+		* Parse a single latitude value. Returns false if the value could not be parsed.
+		*/
+		static bool parseLatitude(const char* value, WGS84Format format, double& latitude) noexcept;
+		/**
+		* Parse a single longitude value. Returns false if the value could not be parsed.
+		*/
+		static bool parseLongitude(const char* value, WGS84Format format, double& longitude) noexcept;
 	protected:
 		static std::string convToDmString(double value, const std::string& positiveValue, const std::string& negativeValue);
 		static std::string convToDmsString(double value, const std::string& positiveValue, const std::string& negativeValue);
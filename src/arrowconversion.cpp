@@ -0,0 +1,259 @@
+/*
+ * arrowconversion.cpp
+ *
+ *  Created on: October 19, 2026
+ *      Author: Bjorn Blissing
+ */
+
+#include "arrowconversion.h"
+#include "gausskreuger.h"
+
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <vector>
+
+namespace vti {
+
+namespace {
+
+const size_t chunk_size = 256;
+
+struct ColumnData {
+	std::vector<double> values;
+	std::vector<uint8_t> validity;
+	const void* buffers[2];
+};
+
+struct StructData {
+	ArrowArray children[2];
+	ArrowArray* child_pointers[2];
+	const void* buffers[1];
+};
+
+struct SchemaData {
+	ArrowSchema children[2];
+	ArrowSchema* child_pointers[2];
+};
+
+void releaseColumn(ArrowArray* array)
+{
+	delete static_cast<ColumnData*>(array->private_data);
+	array->release = nullptr;
+}
+
+void releaseStruct(ArrowArray* array)
+{
+	StructData* data = static_cast<StructData*>(array->private_data);
+
+	// Children moved out by the consumer have already been released.
+	for (int i = 0; i < 2; ++i) {
+		if (data->children[i].release) {
+			data->children[i].release(&data->children[i]);
+		}
+	}
+
+	delete data;
+	array->release = nullptr;
+}
+
+void releaseColumnSchema(ArrowSchema* schema)
+{
+	schema->release = nullptr;
+}
+
+void releaseStructSchema(ArrowSchema* schema)
+{
+	SchemaData* data = static_cast<SchemaData*>(schema->private_data);
+
+	for (int i = 0; i < 2; ++i) {
+		if (data->children[i].release) {
+			data->children[i].release(&data->children[i]);
+		}
+	}
+
+	delete data;
+	schema->release = nullptr;
+}
+
+bool isFloat64Column(const ArrowSchema* schema, const ArrowArray* array)
+{
+	return schema && array && schema->release && array->release &&
+		   schema->format && strcmp(schema->format, "g") == 0 &&
+		   array->n_buffers == 2 && array->n_children == 0 && array->buffers &&
+		   array->length >= 0 && array->offset >= 0 && array->offset <= std::numeric_limits<int64_t>::max() - array->length &&
+		   (array->buffers[1] || array->length == 0);
+}
+
+bool isValid(const ArrowArray* array, int64_t row)
+{
+	if (array->null_count == 0 || !array->buffers[0]) {
+		return true;
+	}
+
+	int64_t bit = array->offset + row;
+	return (static_cast<const uint8_t*>(array->buffers[0])[bit >> 3] >> (bit & 7)) & 1;
+}
+
+// A coordinate system is either geodetic WGS84 (null projection) or a grid.
+bool coordinateSystem(const char* name, GaussKreuger& projection, bool& geodetic)
+{
+	if (!name) {
+		return false;
+	}
+
+	geodetic = strcmp(name, "wgs84") == 0;
+	return geodetic || projection.swedish_params(name);
+}
+
+void initColumnSchema(ArrowSchema& schema, const char* name)
+{
+	memset(&schema, 0, sizeof(schema));
+	schema.format = "g";
+	schema.name = name;
+	schema.flags = ARROW_FLAG_NULLABLE;
+	schema.release = releaseColumnSchema;
+}
+
+void initColumn(ArrowArray& array, ColumnData* data, int64_t length, int64_t nullCount)
+{
+	memset(&array, 0, sizeof(array));
+	data->buffers[0] = nullCount ? &data->validity[0] : nullptr;
+	data->buffers[1] = length ? &data->values[0] : nullptr;
+	array.length = length;
+	array.null_count = nullCount;
+	array.n_buffers = 2;
+	array.buffers = data->buffers;
+	array.release = releaseColumn;
+	array.private_data = data;
+}
+
+} // namespace
+
+} // namespace vti
+
+using namespace vti;
+
+extern "C" int vti_arrow_convert(const char* source, const char* target,
+								 const ArrowSchema* first_schema, const ArrowArray* first,
+								 const ArrowSchema* second_schema, const ArrowArray* second,
+								 ArrowSchema* out_schema, ArrowArray* out_array)
+{
+	GaussKreuger sourceProjection;
+	GaussKreuger targetProjection;
+	bool sourceGeodetic = false;
+	bool targetGeodetic = false;
+
+	if (!out_schema || !out_array ||
+			!coordinateSystem(source, sourceProjection, sourceGeodetic) ||
+			!coordinateSystem(target, targetProjection, targetGeodetic) ||
+			!isFloat64Column(first_schema, first) || !isFloat64Column(second_schema, second) ||
+			first->length != second->length) {
+		return EINVAL;
+	}
+
+	// The length comes from the caller. Reject lengths whose output columns
+	// can not even be sized before allocating them.
+	if (static_cast<uint64_t>(first->length) > std::numeric_limits<size_t>::max() / sizeof(double)) {
+		return EINVAL;
+	}
+
+	const int64_t length = first->length;
+	const double* firstValues = static_cast<const double*>(first->buffers[1]) + first->offset;
+	const double* secondValues = static_cast<const double*>(second->buffers[1]) + second->offset;
+	const bool hasNulls = (first->null_count != 0 && first->buffers[0]) || (second->null_count != 0 && second->buffers[0]);
+	const double nan = std::numeric_limits<double>::quiet_NaN();
+	ColumnData* columns[2] = { nullptr, nullptr };
+	StructData* structData = nullptr;
+	SchemaData* schemaData = nullptr;
+
+	try {
+		columns[0] = new ColumnData;
+		columns[1] = new ColumnData;
+		structData = new StructData;
+		schemaData = new SchemaData;
+		columns[0]->values.resize(static_cast<size_t>(length));
+		columns[1]->values.resize(static_cast<size_t>(length));
+
+		if (hasNulls) {
+			columns[0]->validity.resize(static_cast<size_t>((length + 7) / 8));
+			columns[1]->validity.resize(columns[0]->validity.size());
+		}
+	} catch (...) {
+		// No exception may leave this C function.
+		delete columns[0];
+		delete columns[1];
+		delete structData;
+		delete schemaData;
+		return ENOMEM;
+	}
+
+	// Convert in chunks through a small staging buffer. Null rows are converted
+	// as NaN and masked by the validity bitmap.
+	GaussKreuger::Coordinate chunk[chunk_size];
+	double* firstOut = length ? &columns[0]->values[0] : nullptr;
+	double* secondOut = length ? &columns[1]->values[0] : nullptr;
+	int64_t nullCount = 0;
+
+	for (int64_t begin = 0; begin < length; begin += chunk_size) {
+		size_t count = static_cast<size_t>(length - begin < static_cast<int64_t>(chunk_size) ? length - begin : chunk_size);
+
+		for (size_t i = 0; i < count; ++i) {
+			int64_t row = begin + i;
+			bool valid = !hasNulls || (isValid(first, row) && isValid(second, row));
+			chunk[i].x = valid ? firstValues[row] : nan;
+			chunk[i].y = valid ? secondValues[row] : nan;
+
+			if (hasNulls) {
+				columns[0]->validity[row >> 3] |= static_cast<uint8_t>(valid) << (row & 7);
+				nullCount += valid ? 0 : 1;
+			}
+		}
+
+		if (!sourceGeodetic) {
+			sourceProjection.grid_to_geodetic(chunk, chunk, count);
+		}
+
+		if (!targetGeodetic) {
+			targetProjection.geodetic_to_grid(chunk, chunk, count);
+		}
+
+		for (size_t i = 0; i < count; ++i) {
+			firstOut[begin + i] = chunk[i].x;
+			secondOut[begin + i] = chunk[i].y;
+		}
+	}
+
+	// Both columns share the same validity.
+	if (hasNulls) {
+		memcpy(&columns[1]->validity[0], &columns[0]->validity[0], columns[0]->validity.size());
+	}
+
+	initColumnSchema(schemaData->children[0], targetGeodetic ? "latitude" : "x");
+	initColumnSchema(schemaData->children[1], targetGeodetic ? "longitude" : "y");
+	schemaData->child_pointers[0] = &schemaData->children[0];
+	schemaData->child_pointers[1] = &schemaData->children[1];
+	memset(out_schema, 0, sizeof(*out_schema));
+	out_schema->format = "+s";
+	out_schema->name = "";
+	out_schema->n_children = 2;
+	out_schema->children = schemaData->child_pointers;
+	out_schema->release = releaseStructSchema;
+	out_schema->private_data = schemaData;
+
+	initColumn(structData->children[0], columns[0], length, nullCount);
+	initColumn(structData->children[1], columns[1], length, nullCount);
+	structData->child_pointers[0] = &structData->children[0];
+	structData->child_pointers[1] = &structData->children[1];
+	structData->buffers[0] = nullptr;
+	memset(out_array, 0, sizeof(*out_array));
+	out_array->length = length;
+	out_array->n_buffers = 1;
+	out_array->n_children = 2;
+	out_array->buffers = structData->buffers;
+	out_array->children = structData->child_pointers;
+	out_array->release = releaseStruct;
+	out_array->private_data = structData;
+	return 0;
+}
@@ -0,0 +1,236 @@
+/*
+ * conversionbatcher.cpp
+ *
+ *  Created on: October 19, 2026
+ *      Author: Bjorn Blissing
+ */
+
+#include "conversionbatcher.h"
+
+#include <stdexcept>
+
+namespace vti {
+
+typedef std::chrono::steady_clock Clock;
+
+ConversionBatcher::ConversionBatcher(size_t maxBatchSize, std::chrono::microseconds maxLatency) :
+	m_maxBatchSize(maxBatchSize ? maxBatchSize : 1),
+	m_maxLatency(maxLatency),
+	m_batches(0),
+	m_stopping(false)
+{
+	m_worker = std::thread(&ConversionBatcher::run, this);
+}
+
+ConversionBatcher::~ConversionBatcher()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopping = true;
+	}
+	m_condition.notify_one();
+	m_worker.join();
+}
+
+std::future<GaussKreuger::Coordinate> ConversionBatcher::submit(const std::string& projection, Direction direction, const GaussKreuger::Coordinate& coordinate)
+{
+	Request request;
+	request.single = std::make_shared<std::promise<GaussKreuger::Coordinate> >();
+	std::future<GaussKreuger::Coordinate> result = request.single->get_future();
+	std::unique_lock<std::mutex> lock(m_mutex);
+	Queue* target = queue(projection, direction);
+
+	if (!target) {
+		lock.unlock();
+		request.single->set_exception(std::make_exception_ptr(std::invalid_argument("Unknown projection: " + projection)));
+		return result;
+	}
+
+	bool wake = enqueue(*target, &coordinate, 1, request);
+	lock.unlock();
+
+	if (wake) {
+		m_condition.notify_one();
+	}
+
+	return result;
+}
+
+std::future<std::vector<GaussKreuger::Coordinate> > ConversionBatcher::submit(const std::string& projection, Direction direction,
+		const GaussKreuger::Coordinate* coordinates, size_t count)
+{
+	Request request;
+	request.multiple = std::make_shared<std::promise<std::vector<GaussKreuger::Coordinate> > >();
+	std::future<std::vector<GaussKreuger::Coordinate> > result = request.multiple->get_future();
+	std::unique_lock<std::mutex> lock(m_mutex);
+	Queue* target = queue(projection, direction);
+
+	if (!target) {
+		lock.unlock();
+		request.multiple->set_exception(std::make_exception_ptr(std::invalid_argument("Unknown projection: " + projection)));
+		return result;
+	}
+
+	bool wake = enqueue(*target, coordinates, count, request);
+	lock.unlock();
+
+	if (wake) {
+		m_condition.notify_one();
+	}
+
+	return result;
+}
+
+std::future<GaussKreuger::Coordinate> ConversionBatcher::toWGS84(const RT90Position& position)
+{
+	GaussKreuger::Coordinate grid;
+	grid.x = position.getLatitude();
+	grid.y = position.getLongitude();
+	return submit(RT90Position::getProjectionName(position.getProjection()), Direction::GridToGeodetic, grid);
+}
+
+std::future<GaussKreuger::Coordinate> ConversionBatcher::toWGS84(const SWEREF99Position& position)
+{
+	GaussKreuger::Coordinate grid;
+	grid.x = position.getLatitude();
+	grid.y = position.getLongitude();
+	return submit(SWEREF99Position::getProjectionName(position.getProjection()), Direction::GridToGeodetic, grid);
+}
+
+std::future<GaussKreuger::Coordinate> ConversionBatcher::toRT90(const WGS84Position& position, RT90Position::RT90Projection projection)
+{
+	GaussKreuger::Coordinate lat_lon;
+	lat_lon.x = position.getLatitude();
+	lat_lon.y = position.getLongitude();
+	return submit(RT90Position::getProjectionName(projection), Direction::GeodeticToGrid, lat_lon);
+}
+
+std::future<GaussKreuger::Coordinate> ConversionBatcher::toSWEREF99(const WGS84Position& position, SWEREF99Position::SWEREFProjection projection)
+{
+	GaussKreuger::Coordinate lat_lon;
+	lat_lon.x = position.getLatitude();
+	lat_lon.y = position.getLongitude();
+	return submit(SWEREF99Position::getProjectionName(projection), Direction::GeodeticToGrid, lat_lon);
+}
+
+size_t ConversionBatcher::batches() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_batches;
+}
+
+// Must be called with the mutex held.
+ConversionBatcher::Queue* ConversionBatcher::queue(const std::string& projection, Direction direction)
+{
+	QueueKey key(projection, static_cast<int>(direction));
+	std::map<QueueKey, Queue>::iterator found = m_queues.find(key);
+
+	if (found != m_queues.end()) {
+		return &found->second;
+	}
+
+	Queue created;
+
+	if (!created.projection.swedish_params(projection)) {
+		return nullptr;
+	}
+
+	created.direction = direction;
+	return &m_queues.insert(std::make_pair(key, created)).first->second;
+}
+
+// Must be called with the mutex held. Returns true if the worker has to be
+// woken up, i.e. the queue got a new deadline or just reached the batch size.
+// Otherwise the worker is already waiting for this queue's deadline.
+bool ConversionBatcher::enqueue(Queue& queue, const GaussKreuger::Coordinate* coordinates, size_t count, const Request& request)
+{
+	const bool wasEmpty = queue.requests.empty();
+	const bool wasFull = queue.coordinates.size() >= m_maxBatchSize;
+
+	if (wasEmpty) {
+		queue.deadline = Clock::now() + m_maxLatency;
+	}
+
+	Request queued = request;
+	queued.offset = queue.coordinates.size();
+	queued.count = count;
+	queue.coordinates.insert(queue.coordinates.end(), coordinates, coordinates + count);
+	queue.requests.push_back(queued);
+	return wasEmpty || (!wasFull && queue.coordinates.size() >= m_maxBatchSize);
+}
+
+void ConversionBatcher::run()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	while (true) {
+		Clock::time_point now = Clock::now();
+		Clock::time_point nextDeadline = Clock::time_point::max();
+		Queue* ready = nullptr;
+
+		for (std::map<QueueKey, Queue>::iterator it = m_queues.begin(); it != m_queues.end(); ++it) {
+			Queue& candidate = it->second;
+
+			if (candidate.requests.empty()) {
+				continue;
+			}
+
+			if (m_stopping || candidate.coordinates.size() >= m_maxBatchSize || candidate.deadline <= now) {
+				ready = &candidate;
+				break;
+			}
+
+			if (candidate.deadline < nextDeadline) {
+				nextDeadline = candidate.deadline;
+			}
+		}
+
+		if (!ready) {
+			if (m_stopping) {
+				return;
+			}
+
+			if (nextDeadline == Clock::time_point::max()) {
+				m_condition.wait(lock);
+			} else {
+				m_condition.wait_until(lock, nextDeadline);
+			}
+
+			continue;
+		}
+
+		// Take the queue contents and convert without holding the lock.
+		Queue batch;
+		batch.projection = ready->projection;
+		batch.direction = ready->direction;
+		batch.coordinates.swap(ready->coordinates);
+		batch.requests.swap(ready->requests);
+		++m_batches;
+		lock.unlock();
+		convert(batch);
+		lock.lock();
+	}
+}
+
+void ConversionBatcher::convert(Queue& batch)
+{
+	GaussKreuger::Coordinate* coordinates = batch.coordinates.empty() ? nullptr : &batch.coordinates[0];
+
+	if (batch.direction == Direction::GeodeticToGrid) {
+		batch.projection.geodetic_to_grid(coordinates, coordinates, batch.coordinates.size());
+	} else {
+		batch.projection.grid_to_geodetic(coordinates, coordinates, batch.coordinates.size());
+	}
+
+	for (size_t i = 0; i < batch.requests.size(); ++i) {
+		const Request& request = batch.requests[i];
+
+		if (request.single) {
+			request.single->set_value(coordinates[request.offset]);
+		} else {
+			request.multiple->set_value(std::vector<GaussKreuger::Coordinate>(coordinates + request.offset, coordinates + request.offset + request.count));
+		}
+	}
+}
+
+} // namespace vti
@@ -0,0 +1,720 @@
+/*
+ * conversionserver.cpp
+ *
+ *  Created on: October 19, 2026
+ *      Author: Bjorn Blissing
+ */
+
+#include "conversionserver.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdint.h>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace vti {
+
+namespace {
+
+const uint32_t protocol_magic = 0x56544943; // "VTIC"
+const size_t projection_name_size = 32;
+const size_t ring_slots = 4;
+// Clients that have not completed the handshake by then are dropped.
+const std::chrono::milliseconds handshake_timeout(1000);
+
+enum Direction { geodetic_to_grid_direction = 0, grid_to_geodetic_direction = 1 };
+enum Status { status_ok = 0, status_unknown_projection = 1, status_bad_request = 2 };
+
+// Sent once on connect together with the shared memory descriptor.
+struct Hello {
+	uint32_t magic;
+	uint32_t reserved;
+	uint64_t capacity;
+};
+
+// Convert count coordinates starting at offset in the shared region in place.
+struct Request {
+	uint32_t magic;
+	uint32_t direction;
+	uint64_t offset;
+	uint64_t count;
+	char projection[projection_name_size];
+};
+
+struct Response {
+	uint32_t status;
+	uint32_t reserved;
+	uint64_t count;
+};
+
+#ifdef MSG_NOSIGNAL
+const int send_flags = MSG_NOSIGNAL;
+#else
+const int send_flags = 0;
+#endif
+
+bool sendAll(int fd, const void* data, size_t size)
+{
+	const char* bytes = static_cast<const char*>(data);
+
+	while (size) {
+		ssize_t sent = send(fd, bytes, size, send_flags);
+
+		if (sent < 0 && errno == EINTR) {
+			continue;
+		}
+
+		if (sent <= 0) {
+			return false;
+		}
+
+		bytes += sent;
+		size -= static_cast<size_t>(sent);
+	}
+
+	return true;
+}
+
+bool receiveAll(int fd, void* data, size_t size)
+{
+	char* bytes = static_cast<char*>(data);
+
+	while (size) {
+		ssize_t received = recv(fd, bytes, size, 0);
+
+		if (received < 0 && errno == EINTR) {
+			continue;
+		}
+
+		if (received <= 0) {
+			return false;
+		}
+
+		bytes += received;
+		size -= static_cast<size_t>(received);
+	}
+
+	return true;
+}
+
+// Anonymous shared memory that can be passed to another process as a descriptor.
+int createSharedMemory(size_t size)
+{
+#ifdef __linux__
+	int fd = memfd_create("vti-conversion", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+
+	// The server only accepts regions that can not change size.
+	if (fd >= 0 && (ftruncate(fd, static_cast<off_t>(size)) != 0 || fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW) != 0)) {
+		close(fd);
+		return -1;
+	}
+
+	return fd;
+#else
+	char name[64];
+	static unsigned counter = 0;
+	snprintf(name, sizeof(name), "/vti-conversion-%ld-%u", static_cast<long>(getpid()), counter++);
+	int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+
+	if (fd >= 0) {
+		shm_unlink(name);
+	}
+
+	if (fd >= 0 && ftruncate(fd, static_cast<off_t>(size)) != 0) {
+		close(fd);
+		return -1;
+	}
+
+	return fd;
+#endif
+}
+
+bool setBlocking(int fd, bool blocking)
+{
+	int flags = fcntl(fd, F_GETFL);
+	return flags >= 0 && fcntl(fd, F_SETFL, blocking ? flags & ~O_NONBLOCK : flags | O_NONBLOCK) == 0;
+}
+
+bool socketAddress(const std::string& path, sockaddr_un& address)
+{
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+
+	if (path.size() >= sizeof(address.sun_path)) {
+		errno = ENAMETOOLONG;
+		return false;
+	}
+
+	memcpy(address.sun_path, path.c_str(), path.size() + 1);
+	return true;
+}
+
+// True if a server accepts connections on address.
+bool isListening(const sockaddr_un& address)
+{
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+	if (fd < 0) {
+		return false;
+	}
+
+	bool connected = connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+	close(fd);
+	return connected;
+}
+
+} // namespace
+
+ConversionServer::ConversionServer(const std::string& socketPath) : m_socket_path(socketPath), m_listen_fd(-1)
+{
+	if (pipe(m_stop_pipe) != 0) {
+		m_stop_pipe[0] = m_stop_pipe[1] = -1;
+	}
+}
+
+ConversionServer::~ConversionServer()
+{
+	for (size_t i = 0; i < m_clients.size(); ++i) {
+		close_client(m_clients[i]);
+	}
+
+	if (m_listen_fd >= 0) {
+		close(m_listen_fd);
+		unlink(m_socket_path.c_str());
+	}
+
+	if (m_stop_pipe[0] >= 0) {
+		close(m_stop_pipe[0]);
+		close(m_stop_pipe[1]);
+	}
+}
+
+bool ConversionServer::listen()
+{
+	sockaddr_un address;
+
+	if (m_listen_fd >= 0 || m_stop_pipe[0] < 0 || !socketAddress(m_socket_path, address)) {
+		return false;
+	}
+
+	// Only a socket left by a server that is no longer running is replaced.
+	// Any other file at the path, and a running server, are left alone.
+	struct stat status;
+
+	if (lstat(m_socket_path.c_str(), &status) == 0) {
+		if (!S_ISSOCK(status.st_mode)) {
+			errno = ENOTSOCK;
+			return false;
+		}
+
+		if (isListening(address)) {
+			errno = EADDRINUSE;
+			return false;
+		}
+
+		if (unlink(m_socket_path.c_str()) != 0) {
+			return false;
+		}
+	} else if (errno != ENOENT) {
+		return false;
+	}
+
+	m_listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+	if (m_listen_fd < 0) {
+		return false;
+	}
+
+	if (bind(m_listen_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || ::listen(m_listen_fd, 16) != 0) {
+		int error = errno;
+		close(m_listen_fd);
+		m_listen_fd = -1;
+		errno = error;
+		return false;
+	}
+
+	return true;
+}
+
+void ConversionServer::run()
+{
+	if (m_listen_fd < 0) {
+		return;
+	}
+
+	typedef std::chrono::steady_clock Clock;
+	std::vector<pollfd> fds;
+
+	while (true) {
+		// Wake up in time to drop the first client whose handshake expires.
+		Clock::time_point now = Clock::now();
+		int timeout = -1;
+
+		for (size_t i = 0; i < m_clients.size(); ++i) {
+			if (!m_clients[i].memory) {
+				long long remaining = std::chrono::duration_cast<std::chrono::milliseconds>(m_clients[i].deadline - now).count() + 1;
+				remaining = remaining > 0 ? remaining : 0;
+				timeout = timeout < 0 || remaining < timeout ? static_cast<int>(remaining) : timeout;
+			}
+		}
+
+		fds.resize(2 + m_clients.size());
+		fds[0].fd = m_stop_pipe[0];
+		fds[1].fd = m_listen_fd;
+
+		for (size_t i = 0; i < fds.size(); ++i) {
+			fds[i].events = POLLIN;
+			fds[i].revents = 0;
+		}
+
+		// A client with unsent responses is not read from until they are
+		// sent, so a client that does not read can not make the server
+		// buffer an unbounded number of responses.
+		for (size_t i = 0; i < m_clients.size(); ++i) {
+			fds[2 + i].fd = m_clients[i].fd;
+			fds[2 + i].events = m_clients[i].pending.empty() ? POLLIN : POLLOUT;
+		}
+
+		if (poll(&fds[0], fds.size(), timeout) < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+
+			return;
+		}
+
+		if (fds[0].revents) {
+			char byte;
+
+			while (read(m_stop_pipe[0], &byte, 1) < 0 && errno == EINTR) {
+			}
+
+			return;
+		}
+
+		// Backwards, so closed clients can be removed while iterating.
+		now = Clock::now();
+
+		for (size_t i = m_clients.size(); i-- > 0;) {
+			Client& client = m_clients[i];
+			bool open = true;
+
+			if (!client.memory) {
+				open = (!fds[2 + i].revents || handshake(client)) && (client.memory || now < client.deadline);
+			} else if (fds[2 + i].revents) {
+				open = client.pending.empty() ? serve(client) : flush(client);
+			}
+
+			if (!open) {
+				close_client(client);
+				m_clients.erase(m_clients.begin() + i);
+			}
+		}
+
+		if (fds[1].revents & POLLIN) {
+			accept_client();
+		}
+	}
+}
+
+void ConversionServer::stop()
+{
+	char byte = 0;
+
+	while (write(m_stop_pipe[1], &byte, 1) < 0 && errno == EINTR) {
+	}
+}
+
+bool ConversionServer::accept_client()
+{
+	Client client;
+	client.fd = accept(m_listen_fd, nullptr, nullptr);
+
+	if (client.fd < 0) {
+		return false;
+	}
+
+	// The client is only ever read and written when poll says so, so a slow
+	// or silent client never blocks the others.
+	if (!setBlocking(client.fd, false)) {
+		close(client.fd);
+		return false;
+	}
+
+	client.deadline = std::chrono::steady_clock::now() + handshake_timeout;
+	m_clients.push_back(client);
+	return true;
+}
+
+bool ConversionServer::handshake(Client& client)
+{
+	Hello hello;
+	iovec data;
+	data.iov_base = &hello;
+	data.iov_len = sizeof(hello);
+	union {
+		cmsghdr header;
+		char buffer[CMSG_SPACE(sizeof(int))];
+	} control;
+	msghdr message;
+	memset(&message, 0, sizeof(message));
+	message.msg_iov = &data;
+	message.msg_iovlen = 1;
+	message.msg_control = control.buffer;
+	message.msg_controllen = sizeof(control.buffer);
+
+	ssize_t received;
+
+	do {
+		received = recvmsg(client.fd, &message, 0);
+	} while (received < 0 && errno == EINTR);
+
+	if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+		return true;
+	}
+
+	cmsghdr* header = received == static_cast<ssize_t>(sizeof(hello)) ? CMSG_FIRSTHDR(&message) : nullptr;
+	int memoryFd = -1;
+
+	if (header && header->cmsg_level == SOL_SOCKET && header->cmsg_type == SCM_RIGHTS) {
+		memcpy(&memoryFd, CMSG_DATA(header), sizeof(int));
+	}
+
+	if (memoryFd < 0) {
+		return false;
+	}
+
+	// The capacity comes from the client. Check it against the size of the
+	// region before computing a size in bytes from it.
+	struct stat status;
+	bool valid = hello.magic == protocol_magic && hello.capacity != 0 && fstat(memoryFd, &status) == 0 && status.st_size > 0 &&
+				 hello.capacity <= static_cast<uint64_t>(status.st_size) / sizeof(GaussKreuger::Coordinate);
+#ifdef __linux__
+	// An unsealed region could be truncated after mmap, and the next access
+	// would kill the server with SIGBUS.
+	const int required = F_SEAL_SHRINK | F_SEAL_GROW;
+	int seals = valid ? fcntl(memoryFd, F_GET_SEALS) : -1;
+	valid = seals >= 0 && (seals & required) == required;
+#endif
+
+	void* memory = MAP_FAILED;
+	size_t bytes = static_cast<size_t>(hello.capacity) * sizeof(GaussKreuger::Coordinate);
+
+	if (valid) {
+		memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, memoryFd, 0);
+	}
+
+	close(memoryFd);
+
+	if (memory == MAP_FAILED) {
+		return false;
+	}
+
+	client.memory = static_cast<GaussKreuger::Coordinate*>(memory);
+	client.capacity = static_cast<size_t>(hello.capacity);
+	return true;
+}
+
+bool ConversionServer::serve(Client& client)
+{
+	unsigned char buffer[4096];
+	ssize_t received;
+
+	do {
+		received = recv(client.fd, buffer, sizeof(buffer), 0);
+	} while (received < 0 && errno == EINTR);
+
+	if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+		return true;
+	}
+
+	if (received <= 0) {
+		return false;
+	}
+
+	client.received.insert(client.received.end(), buffer, buffer + received);
+	size_t consumed = 0;
+
+	while (client.received.size() - consumed >= sizeof(Request)) {
+		Request request;
+		memcpy(&request, &client.received[consumed], sizeof(request));
+		consumed += sizeof(request);
+
+		if (request.magic != protocol_magic) {
+			return false;
+		}
+
+		request.projection[projection_name_size - 1] = '\0';
+		Response response;
+		response.status = status_ok;
+		response.reserved = 0;
+		response.count = request.count;
+
+		if (request.direction > grid_to_geodetic_direction || request.offset > client.capacity || request.count > client.capacity - request.offset) {
+			response.status = status_bad_request;
+		} else {
+			const GaussKreuger* kernel = projection(request.projection);
+
+			if (!kernel) {
+				response.status = status_unknown_projection;
+			} else {
+				GaussKreuger::Coordinate* coordinates = client.memory + request.offset;
+				size_t count = static_cast<size_t>(request.count);
+
+				if (request.direction == geodetic_to_grid_direction) {
+					kernel->geodetic_to_grid(coordinates, coordinates, count);
+				} else {
+					kernel->grid_to_geodetic(coordinates, coordinates, count);
+				}
+			}
+		}
+
+		const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&response);
+		client.pending.insert(client.pending.end(), bytes, bytes + sizeof(response));
+	}
+
+	client.received.erase(client.received.begin(), client.received.begin() + consumed);
+	return flush(client);
+}
+
+// Send as much of the pending responses as the socket takes without blocking.
+bool ConversionServer::flush(Client& client)
+{
+	size_t sent = 0;
+
+	while (sent < client.pending.size()) {
+		ssize_t result = send(client.fd, &client.pending[sent], client.pending.size() - sent, send_flags);
+
+		if (result < 0 && errno == EINTR) {
+			continue;
+		}
+
+		if (result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+			break;
+		}
+
+		if (result <= 0) {
+			return false;
+		}
+
+		sent += static_cast<size_t>(result);
+	}
+
+	client.pending.erase(client.pending.begin(), client.pending.begin() + sent);
+	return true;
+}
+
+void ConversionServer::close_client(Client& client)
+{
+	if (client.memory) {
+		munmap(client.memory, client.capacity * sizeof(GaussKreuger::Coordinate));
+		client.memory = nullptr;
+	}
+
+	if (client.fd >= 0) {
+		close(client.fd);
+		client.fd = -1;
+	}
+}
+
+const GaussKreuger* ConversionServer::projection(const char* name)
+{
+	std::map<std::string, GaussKreuger>::iterator found = m_projections.find(name);
+
+	if (found != m_projections.end()) {
+		return &found->second;
+	}
+
+	GaussKreuger kernel;
+
+	if (!kernel.swedish_params(name)) {
+		return nullptr;
+	}
+
+	return &m_projections.insert(std::make_pair(std::string(name), kernel)).first->second;
+}
+
+ConversionClient::ConversionClient() : m_fd(-1), m_memory(nullptr), m_capacity(0)
+{
+}
+
+ConversionClient::~ConversionClient()
+{
+	disconnect();
+}
+
+bool ConversionClient::connect(const std::string& socketPath, size_t capacity)
+{
+	sockaddr_un address;
+	disconnect();
+
+	if (capacity < ring_slots || !socketAddress(socketPath, address)) {
+		return false;
+	}
+
+	m_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+	if (m_fd < 0) {
+		return false;
+	}
+
+	if (::connect(m_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+		disconnect();
+		return false;
+	}
+
+	size_t bytes = capacity * sizeof(GaussKreuger::Coordinate);
+	int memoryFd = createSharedMemory(bytes);
+
+	if (memoryFd < 0) {
+		disconnect();
+		return false;
+	}
+
+	void* memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, memoryFd, 0);
+
+	if (memory == MAP_FAILED) {
+		close(memoryFd);
+		disconnect();
+		return false;
+	}
+
+	m_memory = static_cast<GaussKreuger::Coordinate*>(memory);
+	m_capacity = capacity;
+
+	Hello hello;
+	hello.magic = protocol_magic;
+	hello.reserved = 0;
+	hello.capacity = capacity;
+	iovec data;
+	data.iov_base = &hello;
+	data.iov_len = sizeof(hello);
+	union {
+		cmsghdr header;
+		char buffer[CMSG_SPACE(sizeof(int))];
+	} control;
+	memset(&control, 0, sizeof(control));
+	msghdr message;
+	memset(&message, 0, sizeof(message));
+	message.msg_iov = &data;
+	message.msg_iovlen = 1;
+	message.msg_control = control.buffer;
+	message.msg_controllen = sizeof(control.buffer);
+	cmsghdr* header = CMSG_FIRSTHDR(&message);
+	header->cmsg_level = SOL_SOCKET;
+	header->cmsg_type = SCM_RIGHTS;
+	header->cmsg_len = CMSG_LEN(sizeof(int));
+	memcpy(CMSG_DATA(header), &memoryFd, sizeof(int));
+
+	ssize_t sent;
+
+	do {
+		sent = sendmsg(m_fd, &message, send_flags);
+	} while (sent < 0 && errno == EINTR);
+
+	// The server holds its own mapping from here on.
+	close(memoryFd);
+
+	if (sent != static_cast<ssize_t>(sizeof(hello))) {
+		disconnect();
+		return false;
+	}
+
+	return true;
+}
+
+void ConversionClient::disconnect()
+{
+	if (m_memory) {
+		munmap(m_memory, m_capacity * sizeof(GaussKreuger::Coordinate));
+		m_memory = nullptr;
+		m_capacity = 0;
+	}
+
+	if (m_fd >= 0) {
+		close(m_fd);
+		m_fd = -1;
+	}
+}
+
+bool ConversionClient::geodetic_to_grid(const char* projection, const GaussKreuger::Coordinate* geodetic, GaussKreuger::Coordinate* grid, size_t count)
+{
+	return convert(projection, geodetic_to_grid_direction, geodetic, grid, count);
+}
+
+bool ConversionClient::grid_to_geodetic(const char* projection, const GaussKreuger::Coordinate* grid, GaussKreuger::Coordinate* geodetic, size_t count)
+{
+	return convert(projection, grid_to_geodetic_direction, grid, geodetic, count);
+}
+
+bool ConversionClient::convert(const char* projection, unsigned direction, const GaussKreuger::Coordinate* input, GaussKreuger::Coordinate* output, size_t count)
+{
+	if (!is_connected() || strlen(projection) >= projection_name_size) {
+		return false;
+	}
+
+	// Keep up to ring_slots chunks in flight. The server answers in order,
+	// so the oldest outstanding slot is always the next one to complete.
+	const size_t chunk = m_capacity / ring_slots;
+	size_t begin[ring_slots];
+	size_t length[ring_slots];
+	size_t sent = 0;
+	size_t requests = 0;
+	size_t responses = 0;
+	bool ok = true;
+
+	while (responses < requests || (ok && sent < count)) {
+		if (ok && sent < count && requests - responses < ring_slots) {
+			size_t slot = requests % ring_slots;
+			size_t n = count - sent < chunk ? count - sent : chunk;
+			memcpy(m_memory + slot * chunk, input + sent, n * sizeof(GaussKreuger::Coordinate));
+			Request request;
+			memset(&request, 0, sizeof(request));
+			request.magic = protocol_magic;
+			request.direction = direction;
+			request.offset = slot * chunk;
+			request.count = n;
+			memcpy(request.projection, projection, strlen(projection));
+
+			if (!sendAll(m_fd, &request, sizeof(request))) {
+				disconnect();
+				return false;
+			}
+
+			begin[slot] = sent;
+			length[slot] = n;
+			sent += n;
+			++requests;
+		} else {
+			Response response;
+
+			if (!receiveAll(m_fd, &response, sizeof(response))) {
+				disconnect();
+				return false;
+			}
+
+			size_t slot = responses % ring_slots;
+			++responses;
+
+			if (response.status != status_ok || response.count != length[slot]) {
+				// Stop sending, but drain the outstanding responses.
+				ok = false;
+				continue;
+			}
+
+			memcpy(output + begin[slot], m_memory + slot * chunk, length[slot] * sizeof(GaussKreuger::Coordinate));
+		}
+	}
+
+	return ok;
+}
+
+} // namespace vti
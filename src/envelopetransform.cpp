@@ -0,0 +1,163 @@
+/*
+ * envelopetransform.cpp
+ *
+ *  Created on: October 19, 2026
+ *      Author: Bjorn Blissing
+ */
+
+#include "envelopetransform.h"
+
+#include <cmath>
+
+namespace vti {
+
+namespace {
+
+// Each edge starts out split in this many segments, so that symmetric
+// curves, whose midpoint falls on the chord, are still detected.
+const int initial_segments = 4;
+// Limit of the bisection depth per initial segment.
+const int max_depth = 16;
+
+void extend(GaussKreuger::Bounds& bounds, const GaussKreuger::Coordinate& point)
+{
+	if (point.x < bounds.min_x) {
+		bounds.min_x = point.x;
+	}
+
+	if (point.x > bounds.max_x) {
+		bounds.max_x = point.x;
+	}
+
+	if (point.y < bounds.min_y) {
+		bounds.min_y = point.y;
+	}
+
+	if (point.y > bounds.max_y) {
+		bounds.max_y = point.y;
+	}
+}
+
+GaussKreuger::Coordinate lerp(const GaussKreuger::Coordinate& a, const GaussKreuger::Coordinate& b, double t)
+{
+	GaussKreuger::Coordinate result;
+	result.x = a.x + (b.x - a.x) * t;
+	result.y = a.y + (b.y - a.y) * t;
+	return result;
+}
+
+// Distance from point to the line through a and b.
+double distanceToChord(const GaussKreuger::Coordinate& a, const GaussKreuger::Coordinate& b, const GaussKreuger::Coordinate& point)
+{
+	double dx = b.x - a.x;
+	double dy = b.y - a.y;
+	double length = sqrt(dx * dx + dy * dy);
+
+	if (length == 0.0) {
+		return sqrt((point.x - a.x) * (point.x - a.x) + (point.y - a.y) * (point.y - a.y));
+	}
+
+	return fabs(dx * (point.y - a.y) - dy * (point.x - a.x)) / length;
+}
+
+} // namespace
+
+EnvelopeTransform::EnvelopeTransform(const GaussKreuger* sourceProjection, const GaussKreuger* targetProjection, double tolerance) :
+	m_sourceProjection(sourceProjection),
+	m_targetProjection(targetProjection),
+	m_tolerance(tolerance)
+{
+}
+
+GaussKreuger::Coordinate EnvelopeTransform::transform(const GaussKreuger::Coordinate& source) const
+{
+	GaussKreuger::Coordinate lat_lon = source;
+
+	if (m_sourceProjection) {
+		lat_lon = m_sourceProjection->grid_to_geodetic(source.x, source.y);
+	}
+
+	if (m_targetProjection) {
+		return m_targetProjection->geodetic_to_grid(lat_lon.x, lat_lon.y);
+	}
+
+	return lat_lon;
+}
+
+GaussKreuger::Bounds EnvelopeTransform::transform(const GaussKreuger::Bounds& bounds, size_t* evaluations) const
+{
+	GaussKreuger::Coordinate corners[4];
+	corners[0].x = bounds.min_x;
+	corners[0].y = bounds.min_y;
+	corners[1].x = bounds.min_x;
+	corners[1].y = bounds.max_y;
+	corners[2].x = bounds.max_x;
+	corners[2].y = bounds.max_y;
+	corners[3].x = bounds.max_x;
+	corners[3].y = bounds.min_y;
+	GaussKreuger::Coordinate transformed[4];
+
+	for (int i = 0; i < 4; ++i) {
+		transformed[i] = transform(corners[i]);
+	}
+
+	size_t count = 4;
+	GaussKreuger::Bounds result;
+	result.min_x = result.max_x = transformed[0].x;
+	result.min_y = result.max_y = transformed[0].y;
+
+	// The transformations are smooth and one-to-one, so the extremes of the
+	// transformed rectangle lie on its edges.
+	for (int edge = 0; edge < 4; ++edge) {
+		const GaussKreuger::Coordinate& begin = corners[edge];
+		const GaussKreuger::Coordinate& end = corners[(edge + 1) % 4];
+		GaussKreuger::Coordinate previousSource = begin;
+		GaussKreuger::Coordinate previousTarget = transformed[edge];
+		extend(result, previousTarget);
+
+		for (int segment = 1; segment <= initial_segments; ++segment) {
+			GaussKreuger::Coordinate source = segment == initial_segments ? end : lerp(begin, end, static_cast<double>(segment) / initial_segments);
+			GaussKreuger::Coordinate target = segment == initial_segments ? transformed[(edge + 1) % 4] : transform(source);
+
+			if (segment != initial_segments) {
+				++count;
+			}
+
+			extend(result, target);
+			densify(previousSource, source, previousTarget, target, 0, result, count);
+			previousSource = source;
+			previousTarget = target;
+		}
+	}
+
+	// Points between the samples deviate at most about the tolerance from the chords.
+	result.min_x -= m_tolerance;
+	result.min_y -= m_tolerance;
+	result.max_x += m_tolerance;
+	result.max_y += m_tolerance;
+
+	if (evaluations) {
+		*evaluations = count;
+	}
+
+	return result;
+}
+
+void EnvelopeTransform::densify(const GaussKreuger::Coordinate& sourceBegin, const GaussKreuger::Coordinate& sourceEnd,
+								const GaussKreuger::Coordinate& targetBegin, const GaussKreuger::Coordinate& targetEnd,
+								int depth, GaussKreuger::Bounds& result, size_t& evaluations) const
+{
+	GaussKreuger::Coordinate sourceMiddle = lerp(sourceBegin, sourceEnd, 0.5);
+	GaussKreuger::Coordinate targetMiddle = transform(sourceMiddle);
+	++evaluations;
+	extend(result, targetMiddle);
+
+	if (depth >= max_depth || distanceToChord(targetBegin, targetEnd, targetMiddle) <= m_tolerance) {
+		return;
+	}
+
+	densify(sourceBegin, sourceMiddle, targetBegin, targetMiddle, depth + 1, result, evaluations);
+	densify(sourceMiddle, sourceEnd, targetMiddle, targetEnd, depth + 1, result, evaluations);
+}
+
+} // namespace vti
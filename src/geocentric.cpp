@@ -0,0 +1,109 @@
+/*
+ * geocentric.cpp
+ *
+ *  Created on: October 19, 2026
+ *      Author: Bjorn Blissing
+ */
+
+#include "geocentric.h"
+
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.1415926535897932384626433832
+#endif
+
+namespace vti {
+
+Geocentric::Geocentric(const Ellipsoid& ellipsoid) : m_ellipsoid(ellipsoid)
+{
+	m_e2 = m_ellipsoid.flattening * (2.0 - m_ellipsoid.flattening);
+	m_b = m_ellipsoid.axis * (1.0 - m_ellipsoid.flattening);
+	m_ep2 = m_e2 / (1.0 - m_e2);
+}
+
+Geocentric::Cartesian Geocentric::geodetic_to_geocentric(double latitude, double longitude, double height) const
+{
+	double deg_to_rad = M_PI / 180.0;
+	double phi = latitude * deg_to_rad;
+	double lambda = longitude * deg_to_rad;
+	double sin_phi = sin(phi);
+	double cos_phi = cos(phi);
+	// Prime vertical radius of curvature.
+	double N = m_ellipsoid.axis / sqrt(1.0 - m_e2 * sin_phi * sin_phi);
+	Cartesian xyz;
+	xyz.x = (N + height) * cos_phi * cos(lambda);
+	xyz.y = (N + height) * cos_phi * sin(lambda);
+	xyz.z = (N * (1.0 - m_e2) + height) * sin_phi;
+	return xyz;
+}
+
+Geocentric::Geodetic Geocentric::geocentric_to_geodetic(const Cartesian& geocentric) const
+{
+	const double a = m_ellipsoid.axis;
+	const double b = m_b;
+	const double e2 = m_e2;
+	double x = geocentric.x;
+	double y = geocentric.y;
+	double z = geocentric.z;
+	double r2 = x * x + y * y;
+	double r = sqrt(r2);
+	double F = 54.0 * b * b * z * z;
+	double G = r2 + (1.0 - e2) * z * z - e2 * (a * a - b * b);
+	double c = e2 * e2 * F * r2 / (G * G * G);
+	double s = cbrt(1.0 + c + sqrt(c * c + 2.0 * c));
+	double k = s + 1.0 / s + 1.0;
+	double P = F / (3.0 * k * k * G * G);
+	double Q = sqrt(1.0 + 2.0 * e2 * e2 * P);
+	double r0 = -(P * e2 * r) / (1.0 + Q) +
+				sqrt(a * a / 2.0 * (1.0 + 1.0 / Q) -
+					 P * (1.0 - e2) * z * z / (Q * (1.0 + Q)) -
+					 P * r2 / 2.0);
+	double U = sqrt((r - e2 * r0) * (r - e2 * r0) + z * z);
+	double V = sqrt((r - e2 * r0) * (r - e2 * r0) + (1.0 - e2) * z * z);
+	double z0 = b * b * z / (a * V);
+	double rad_to_deg = 180.0 / M_PI;
+	Geodetic lat_lon;
+	lat_lon.latitude = atan2(z + m_ep2 * z0, r) * rad_to_deg;
+	lat_lon.longitude = atan2(y, x) * rad_to_deg;
+	lat_lon.height = U * (1.0 - b * b / (a * V));
+	return lat_lon;
+}
+
+void Geocentric::geodetic_to_geocentric(const Geodetic* geodetic, Cartesian* geocentric, size_t count) const
+{
+	for (size_t i = 0; i < count; ++i) {
+		geocentric[i] = geodetic_to_geocentric(geodetic[i].latitude, geodetic[i].longitude, geodetic[i].height);
+	}
+}
+
+void Geocentric::geocentric_to_geodetic(const Cartesian* geocentric, Geodetic* geodetic, size_t count) const
+{
+	for (size_t i = 0; i < count; ++i) {
+		geodetic[i] = geocentric_to_geodetic(geocentric[i]);
+	}
+}
+
+void Geocentric::geodetic_to_geocentric(const double* latitude, const double* longitude, const double* height,
+										double* x, double* y, double* z, size_t count) const
+{
+	for (size_t i = 0; i < count; ++i) {
+		Cartesian xyz = geodetic_to_geocentric(latitude[i], longitude[i], height[i]);
+		x[i] = xyz.x;
+		y[i] = xyz.y;
+		z[i] = xyz.z;
+	}
+}
+
+void Geocentric::geocentric_to_geodetic(const double* x, const double* y, const double* z,
+										double* latitude, double* longitude, double* height, size_t count) const
+{
+	for (size_t i = 0; i < count; ++i) {
+		Geodetic lat_lon = geocentric_to_geodetic(Cartesian(x[i], y[i], z[i]));
+		latitude[i] = lat_lon.latitude;
+		longitude[i] = lat_lon.longitude;
+		height[i] = lat_lon.height;
+	}
+}
+
+} // namespace vti
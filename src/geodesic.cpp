@@ -0,0 +1,241 @@
+/*
+ * geodesic.cpp
+ *
+ *  Created on: October 19, 2026
+ *      Author: Bjorn Blissing
+ */
+
+#include "geodesic.h"
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.1415926535897932384626433832
+#endif
+
+namespace vti {
+
+namespace {
+
+const int max_iterations = 200;
+const double convergence_limit = 1e-12;
+
+double normalizeAzimuth(double degrees)
+{
+	degrees = fmod(degrees, 360.0);
+	return degrees < 0.0 ? degrees + 360.0 : degrees;
+}
+
+} // namespace
+
+Geodesic::Geodesic(const Ellipsoid& ellipsoid) : m_ellipsoid(ellipsoid), m_b(ellipsoid.axis * (1.0 - ellipsoid.flattening))
+{
+}
+
+Geodesic::Reduced Geodesic::reduce(double latitude, double longitude) const
+{
+	double deg_to_rad = M_PI / 180.0;
+	double u = atan((1.0 - m_ellipsoid.flattening) * tan(latitude * deg_to_rad));
+	Reduced reduced;
+	reduced.sin_u = sin(u);
+	reduced.cos_u = cos(u);
+	reduced.lambda = longitude * deg_to_rad;
+	return reduced;
+}
+
+Geodesic::InverseResult Geodesic::inverse(double latitude1, double longitude1, double latitude2, double longitude2) const
+{
+	return inverse(reduce(latitude1, longitude1), reduce(latitude2, longitude2), true);
+}
+
+Geodesic::InverseResult Geodesic::inverse(const Reduced& first, const Reduced& second, bool azimuths) const
+{
+	const double a = m_ellipsoid.axis;
+	const double b = m_b;
+	const double f = m_ellipsoid.flattening;
+	const double sinU1 = first.sin_u;
+	const double cosU1 = first.cos_u;
+	const double sinU2 = second.sin_u;
+	const double cosU2 = second.cos_u;
+	const double L = second.lambda - first.lambda;
+	double lambda = L;
+	double sin_lambda = 0.0;
+	double cos_lambda = 0.0;
+	double sin_sigma = 0.0;
+	double cos_sigma = 0.0;
+	double sigma = 0.0;
+	double cos2_alpha = 0.0;
+	double cos_2sigma_m = 0.0;
+	InverseResult result;
+	result.converged = false;
+
+	for (int i = 0; i < max_iterations; ++i) {
+		sin_lambda = sin(lambda);
+		cos_lambda = cos(lambda);
+		double t1 = cosU2 * sin_lambda;
+		double t2 = cosU1 * sinU2 - sinU1 * cosU2 * cos_lambda;
+		sin_sigma = sqrt(t1 * t1 + t2 * t2);
+
+		if (sin_sigma == 0.0) {
+			// Coincident points.
+			result.converged = true;
+			return result;
+		}
+
+		cos_sigma = sinU1 * sinU2 + cosU1 * cosU2 * cos_lambda;
+		sigma = atan2(sin_sigma, cos_sigma);
+		double sin_alpha = cosU1 * cosU2 * sin_lambda / sin_sigma;
+		cos2_alpha = 1.0 - sin_alpha * sin_alpha;
+		// On the equator cos2_alpha is zero.
+		cos_2sigma_m = cos2_alpha != 0.0 ? cos_sigma - 2.0 * sinU1 * sinU2 / cos2_alpha : 0.0;
+		double C = f / 16.0 * cos2_alpha * (4.0 + f * (4.0 - 3.0 * cos2_alpha));
+		double previous = lambda;
+		lambda = L + (1.0 - C) * f * sin_alpha *
+				 (sigma + C * sin_sigma * (cos_2sigma_m + C * cos_sigma * (-1.0 + 2.0 * cos_2sigma_m * cos_2sigma_m)));
+
+		if (fabs(lambda - previous) < convergence_limit) {
+			result.converged = true;
+			break;
+		}
+	}
+
+	double u2 = cos2_alpha * (a * a - b * b) / (b * b);
+	double A = 1.0 + u2 / 16384.0 * (4096.0 + u2 * (-768.0 + u2 * (320.0 - 175.0 * u2)));
+	double B = u2 / 1024.0 * (256.0 + u2 * (-128.0 + u2 * (74.0 - 47.0 * u2)));
+	double delta_sigma = B * sin_sigma * (cos_2sigma_m + B / 4.0 *
+										  (cos_sigma * (-1.0 + 2.0 * cos_2sigma_m * cos_2sigma_m) -
+										   B / 6.0 * cos_2sigma_m * (-3.0 + 4.0 * sin_sigma * sin_sigma) * (-3.0 + 4.0 * cos_2sigma_m * cos_2sigma_m)));
+	result.distance = b * A * (sigma - delta_sigma);
+
+	if (azimuths) {
+		double rad_to_deg = 180.0 / M_PI;
+		double alpha1 = atan2(cosU2 * sin_lambda, cosU1 * sinU2 - sinU1 * cosU2 * cos_lambda);
+		double alpha2 = atan2(cosU1 * sin_lambda, -sinU1 * cosU2 + cosU1 * sinU2 * cos_lambda);
+		result.forward_azimuth = normalizeAzimuth(alpha1 * rad_to_deg);
+		result.back_azimuth = normalizeAzimuth(alpha2 * rad_to_deg + 180.0);
+	}
+
+	return result;
+}
+
+Geodesic::DirectResult Geodesic::direct(double latitude, double longitude, double azimuth, double distance) const
+{
+	const double a = m_ellipsoid.axis;
+	const double b = m_b;
+	const double f = m_ellipsoid.flattening;
+	double deg_to_rad = M_PI / 180.0;
+	double alpha1 = azimuth * deg_to_rad;
+	double sin_alpha1 = sin(alpha1);
+	double cos_alpha1 = cos(alpha1);
+	double tanU1 = (1.0 - f) * tan(latitude * deg_to_rad);
+	double cosU1 = 1.0 / sqrt(1.0 + tanU1 * tanU1);
+	double sinU1 = tanU1 * cosU1;
+	double sigma1 = atan2(tanU1, cos_alpha1);
+	double sin_alpha = cosU1 * sin_alpha1;
+	double cos2_alpha = 1.0 - sin_alpha * sin_alpha;
+	double u2 = cos2_alpha * (a * a - b * b) / (b * b);
+	double A = 1.0 + u2 / 16384.0 * (4096.0 + u2 * (-768.0 + u2 * (320.0 - 175.0 * u2)));
+	double B = u2 / 1024.0 * (256.0 + u2 * (-128.0 + u2 * (74.0 - 47.0 * u2)));
+	double sigma = distance / (b * A);
+	double sin_sigma = 0.0;
+	double cos_sigma = 0.0;
+	double cos_2sigma_m = 0.0;
+
+	for (int i = 0; i < max_iterations; ++i) {
+		cos_2sigma_m = cos(2.0 * sigma1 + sigma);
+		sin_sigma = sin(sigma);
+		cos_sigma = cos(sigma);
+		double delta_sigma = B * sin_sigma * (cos_2sigma_m + B / 4.0 *
+											  (cos_sigma * (-1.0 + 2.0 * cos_2sigma_m * cos_2sigma_m) -
+											   B / 6.0 * cos_2sigma_m * (-3.0 + 4.0 * sin_sigma * sin_sigma) * (-3.0 + 4.0 * cos_2sigma_m * cos_2sigma_m)));
+		double previous = sigma;
+		sigma = distance / (b * A) + delta_sigma;
+
+		if (fabs(sigma - previous) < convergence_limit) {
+			break;
+		}
+	}
+
+	cos_2sigma_m = cos(2.0 * sigma1 + sigma);
+	sin_sigma = sin(sigma);
+	cos_sigma = cos(sigma);
+	double tmp = sinU1 * sin_sigma - cosU1 * cos_sigma * cos_alpha1;
+	double phi2 = atan2(sinU1 * cos_sigma + cosU1 * sin_sigma * cos_alpha1,
+						(1.0 - f) * sqrt(sin_alpha * sin_alpha + tmp * tmp));
+	double lambda = atan2(sin_sigma * sin_alpha1, cosU1 * cos_sigma - sinU1 * sin_sigma * cos_alpha1);
+	double C = f / 16.0 * cos2_alpha * (4.0 + f * (4.0 - 3.0 * cos2_alpha));
+	double L = lambda - (1.0 - C) * f * sin_alpha *
+			   (sigma + C * sin_sigma * (cos_2sigma_m + C * cos_sigma * (-1.0 + 2.0 * cos_2sigma_m * cos_2sigma_m)));
+	double rad_to_deg = 180.0 / M_PI;
+	DirectResult result;
+	result.latitude = phi2 * rad_to_deg;
+	result.longitude = longitude + L * rad_to_deg;
+	result.azimuth = normalizeAzimuth(atan2(sin_alpha, -tmp) * rad_to_deg);
+	return result;
+}
+
+void Geodesic::inverse(const GaussKreuger::Coordinate* from, const GaussKreuger::Coordinate* to, InverseResult* results, size_t count) const
+{
+	for (size_t i = 0; i < count; ++i) {
+		results[i] = inverse(reduce(from[i].x, from[i].y), reduce(to[i].x, to[i].y), true);
+	}
+}
+
+void Geodesic::direct(const GaussKreuger::Coordinate* from, const double* azimuths, const double* distances, DirectResult* results, size_t count) const
+{
+	for (size_t i = 0; i < count; ++i) {
+		results[i] = direct(from[i].x, from[i].y, azimuths[i], distances[i]);
+	}
+}
+
+size_t Geodesic::distance_matrix(const GaussKreuger::Coordinate* origins, size_t originCount,
+								 const GaussKreuger::Coordinate* destinations, size_t destinationCount, double* distances) const
+{
+	size_t failed = 0;
+	std::vector<Reduced> reduced(destinationCount);
+
+	for (size_t j = 0; j < destinationCount; ++j) {
+		reduced[j] = reduce(destinations[j].x, destinations[j].y);
+	}
+
+	for (size_t i = 0; i < originCount; ++i) {
+		Reduced origin = reduce(origins[i].x, origins[i].y);
+		double* row = distances + i * destinationCount;
+
+		for (size_t j = 0; j < destinationCount; ++j) {
+			InverseResult result = inverse(origin, reduced[j], false);
+			row[j] = result.converged ? result.distance : std::numeric_limits<double>::quiet_NaN();
+			failed += result.converged ? 0 : 1;
+		}
+	}
+
+	return failed;
+}
+
+size_t Geodesic::distance_matrix(const GaussKreuger::Coordinate* points, size_t count, double* distances) const
+{
+	size_t failed = 0;
+	std::vector<Reduced> reduced(count);
+
+	for (size_t i = 0; i < count; ++i) {
+		reduced[i] = reduce(points[i].x, points[i].y);
+	}
+
+	for (size_t i = 0; i < count; ++i) {
+		distances[i * count + i] = 0.0;
+
+		for (size_t j = i + 1; j < count; ++j) {
+			InverseResult result = inverse(reduced[i], reduced[j], false);
+			double distance = result.converged ? result.distance : std::numeric_limits<double>::quiet_NaN();
+			distances[i * count + j] = distance;
+			distances[j * count + i] = distance;
+			failed += result.converged ? 0 : 1;
+		}
+	}
+
+	return failed;
+}
+
+} // namespace vti
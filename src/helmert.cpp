@@ -0,0 +1,136 @@
+/*
+ * helmert.cpp
+ *
+ *  Created on: October 19, 2026
+ *      Author: Bjorn Blissing
+ */
+
+#include "helmert.h"
+
+#ifndef M_PI
+#define M_PI 3.1415926535897932384626433832
+#endif
+
+namespace vti {
+
+namespace {
+
+const size_t chunk_size = 256;
+
+} // namespace
+
+Helmert::Helmert(const Ellipsoid& source, const Ellipsoid& target, const Parameters& parameters) :
+	m_source(source), m_target(target)
+{
+	double arcsec_to_rad = M_PI / (180.0 * 3600.0);
+	double rx = parameters.rx * arcsec_to_rad;
+	double ry = parameters.ry * arcsec_to_rad;
+	double rz = parameters.rz * arcsec_to_rad;
+	double s = 1.0 + parameters.scale * 1e-6;
+	// Small angle rotation matrix, position vector convention.
+	m_matrix[0] = s;
+	m_matrix[1] = -s * rz;
+	m_matrix[2] = s * ry;
+	m_matrix[3] = s * rz;
+	m_matrix[4] = s;
+	m_matrix[5] = -s * rx;
+	m_matrix[6] = -s * ry;
+	m_matrix[7] = s * rx;
+	m_matrix[8] = s;
+	m_translation[0] = parameters.tx;
+	m_translation[1] = parameters.ty;
+	m_translation[2] = parameters.tz;
+}
+
+Helmert Helmert::rt90_to_sweref99()
+{
+	Parameters parameters;
+	parameters.tx = 414.1055246174;
+	parameters.ty = 41.3265500042;
+	parameters.tz = 603.0582474221;
+	parameters.rx = -0.8551163377;
+	parameters.ry = 2.1413174055;
+	parameters.rz = -7.0227298286;
+	parameters.scale = 0.0;
+	return Helmert(Ellipsoid::bessel(), Ellipsoid::grs80(), parameters);
+}
+
+Helmert Helmert::inverse() const
+{
+	// X = M^-1 (X' - T)
+	const double* m = m_matrix;
+	double determinant = m[0] * (m[4] * m[8] - m[5] * m[7]) -
+						 m[1] * (m[3] * m[8] - m[5] * m[6]) +
+						 m[2] * (m[3] * m[7] - m[4] * m[6]);
+	Helmert result(m_target, m_source);
+	double* r = result.m_matrix;
+	r[0] = (m[4] * m[8] - m[5] * m[7]) / determinant;
+	r[1] = (m[2] * m[7] - m[1] * m[8]) / determinant;
+	r[2] = (m[1] * m[5] - m[2] * m[4]) / determinant;
+	r[3] = (m[5] * m[6] - m[3] * m[8]) / determinant;
+	r[4] = (m[0] * m[8] - m[2] * m[6]) / determinant;
+	r[5] = (m[2] * m[3] - m[0] * m[5]) / determinant;
+	r[6] = (m[3] * m[7] - m[4] * m[6]) / determinant;
+	r[7] = (m[1] * m[6] - m[0] * m[7]) / determinant;
+	r[8] = (m[0] * m[4] - m[1] * m[3]) / determinant;
+
+	for (int row = 0; row < 3; ++row) {
+		result.m_translation[row] = -(r[row * 3] * m_translation[0] + r[row * 3 + 1] * m_translation[1] + r[row * 3 + 2] * m_translation[2]);
+	}
+
+	return result;
+}
+
+Geocentric::Cartesian Helmert::transform(const Geocentric::Cartesian& geocentric) const
+{
+	const double* m = m_matrix;
+	Geocentric::Cartesian xyz;
+	xyz.x = m_translation[0] + m[0] * geocentric.x + m[1] * geocentric.y + m[2] * geocentric.z;
+	xyz.y = m_translation[1] + m[3] * geocentric.x + m[4] * geocentric.y + m[5] * geocentric.z;
+	xyz.z = m_translation[2] + m[6] * geocentric.x + m[7] * geocentric.y + m[8] * geocentric.z;
+	return xyz;
+}
+
+Geocentric::Geodetic Helmert::transform(double latitude, double longitude, double height) const
+{
+	return m_target.geocentric_to_geodetic(transform(m_source.geodetic_to_geocentric(latitude, longitude, height)));
+}
+
+void Helmert::transform(const Geocentric::Geodetic* source, Geocentric::Geodetic* target, size_t count) const
+{
+	for (size_t i = 0; i < count; ++i) {
+		target[i] = transform(source[i].latitude, source[i].longitude, source[i].height);
+	}
+}
+
+void Helmert::transform(const double* latitude, const double* longitude, const double* height,
+						double* targetLatitude, double* targetLongitude, double* targetHeight, size_t count) const
+{
+	const double* m = m_matrix;
+	const double tx = m_translation[0];
+	const double ty = m_translation[1];
+	const double tz = m_translation[2];
+	double x[chunk_size];
+	double y[chunk_size];
+	double z[chunk_size];
+	double zero[chunk_size] = { 0.0 };
+	double discard[chunk_size];
+
+	for (size_t begin = 0; begin < count; begin += chunk_size) {
+		size_t n = count - begin < chunk_size ? count - begin : chunk_size;
+		m_source.geodetic_to_geocentric(latitude + begin, longitude + begin, height ? height + begin : zero, x, y, z, n);
+
+		for (size_t i = 0; i < n; ++i) {
+			double sx = x[i];
+			double sy = y[i];
+			double sz = z[i];
+			x[i] = tx + m[0] * sx + m[1] * sy + m[2] * sz;
+			y[i] = ty + m[3] * sx + m[4] * sy + m[5] * sz;
+			z[i] = tz + m[6] * sx + m[7] * sy + m[8] * sz;
+		}
+
+		m_target.geocentric_to_geodetic(x, y, z, targetLatitude + begin, targetLongitude + begin, targetHeight ? targetHeight + begin : discard, n);
+	}
+}
+
+} // namespace vti
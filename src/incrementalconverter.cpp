@@ -0,0 +1,240 @@
+/*
+ * incrementalconverter.cpp
+ *
+ *  Created on: October 19, 2026
+ *      Author: Bjorn Blissing
+ */
+
+#include "incrementalconverter.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace vti {
+
+namespace {
+
+const uint64_t fnv_offset = 14695981039346656037ULL;
+const uint64_t fnv_prime = 1099511628211ULL;
+
+// Cache file layout, in native byte order: a FileHeader followed by one
+// BlockHeader and count coordinates per block.
+const uint32_t file_magic = 0x56544942; // "VTIB"
+const uint32_t file_version = 1;
+
+struct FileHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint64_t parameters;
+	uint64_t block_size;
+	uint64_t blocks;
+};
+
+struct BlockHeader {
+	uint64_t hash;
+	uint64_t count;
+};
+
+uint64_t fnv1a(const void* data, size_t size, uint64_t hash)
+{
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+
+	for (size_t i = 0; i < size; ++i) {
+		hash = (hash ^ bytes[i]) * fnv_prime;
+	}
+
+	return hash;
+}
+
+uint64_t fnv1a(const GaussKreuger::Coordinate& coordinate)
+{
+	double values[2] = { coordinate.x, coordinate.y };
+	return fnv1a(values, sizeof(values), fnv_offset);
+}
+
+// Gives access to the parameters of a projection.
+class ProjectionParameters : public GaussKreuger {
+public:
+	explicit ProjectionParameters(const GaussKreuger& projection) : GaussKreuger(projection) {}
+
+	uint64_t hash(uint64_t seed) const
+	{
+		double values[6] = { m_axis, m_flattening, m_central_meridian, m_scale, m_false_northing, m_false_easting };
+		return fnv1a(values, sizeof(values), seed);
+	}
+};
+
+} // namespace
+
+IncrementalConverter::IncrementalConverter(const GaussKreuger& projection, Direction direction, size_t blockSize) :
+	m_projection(projection),
+	m_direction(direction),
+	m_block_size(blockSize > 4 ? blockSize : 4),
+	m_blocks(0),
+	m_reconverted(0)
+{
+	uint32_t directionValue = static_cast<uint32_t>(direction);
+	m_parameters = ProjectionParameters(projection).hash(fnv1a(&directionValue, sizeof(directionValue), fnv_offset));
+}
+
+void IncrementalConverter::convert_block(const GaussKreuger::Coordinate* input, GaussKreuger::Coordinate* output, size_t count) const
+{
+	if (m_direction == Direction::GeodeticToGrid) {
+		m_projection.geodetic_to_grid(input, output, count);
+	} else {
+		m_projection.grid_to_geodetic(input, output, count);
+	}
+}
+
+void IncrementalConverter::convert(const GaussKreuger::Coordinate* input, GaussKreuger::Coordinate* output, size_t count)
+{
+	const size_t minimum = m_block_size / 4;
+	const size_t maximum = m_block_size * 4;
+	BlockMap cache;
+	std::vector<GaussKreuger::Coordinate> cachedOutput;
+	cachedOutput.reserve(count);
+	m_blocks = 0;
+	m_reconverted = 0;
+	size_t begin = 0;
+
+	while (begin < count) {
+		// The block hash is seeded with the parameters, so a cache for another
+		// projection never matches.
+		uint64_t hash = m_parameters;
+		size_t end = begin;
+
+		while (end < count) {
+			uint64_t record = fnv1a(input[end]);
+			hash = (hash ^ record) * fnv_prime;
+			size_t length = ++end - begin;
+
+			// The high bits of FNV-1a are the best mixed.
+			if (length >= maximum || (length >= minimum && (record >> 32) % m_block_size == 0)) {
+				break;
+			}
+		}
+
+		size_t length = end - begin;
+		BlockMap::const_iterator cached = m_cache.find(hash);
+
+		// The input has been hashed, so output may overwrite it from here on.
+		if (cached != m_cache.end() && cached->second.count == length) {
+			memmove(output + begin, &m_output[cached->second.offset], length * sizeof(GaussKreuger::Coordinate));
+		} else {
+			convert_block(input + begin, output + begin, length);
+			++m_reconverted;
+		}
+
+		if (cache.find(hash) == cache.end()) {
+			Block block;
+			block.count = length;
+			block.offset = cachedOutput.size();
+			cache[hash] = block;
+			cachedOutput.insert(cachedOutput.end(), output + begin, output + end);
+		}
+
+		++m_blocks;
+		begin = end;
+	}
+
+	m_cache.swap(cache);
+	m_output.swap(cachedOutput);
+}
+
+bool IncrementalConverter::load(const std::string& path)
+{
+	m_cache.clear();
+	m_output.clear();
+	std::ifstream file(path.c_str(), std::ios::binary);
+	FileHeader header;
+
+	if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+		header.magic != file_magic || header.version != file_version ||
+		header.parameters != m_parameters || header.block_size != m_block_size) {
+		return false;
+	}
+
+	BlockMap cache;
+	std::vector<GaussKreuger::Coordinate> output;
+
+	for (uint64_t i = 0; i < header.blocks; ++i) {
+		BlockHeader blockHeader;
+
+		if (!file.read(reinterpret_cast<char*>(&blockHeader), sizeof(blockHeader)) ||
+			blockHeader.count == 0 || blockHeader.count > m_block_size * 4) {
+			return false;
+		}
+
+		Block block;
+		block.count = static_cast<size_t>(blockHeader.count);
+		block.offset = output.size();
+		output.resize(output.size() + block.count);
+
+		for (size_t k = block.offset; k < output.size(); ++k) {
+			double values[2];
+
+			if (!file.read(reinterpret_cast<char*>(values), sizeof(values))) {
+				return false;
+			}
+
+			output[k].x = values[0];
+			output[k].y = values[1];
+		}
+
+		cache[blockHeader.hash] = block;
+	}
+
+	m_cache.swap(cache);
+	m_output.swap(output);
+	return true;
+}
+
+bool IncrementalConverter::save(const std::string& path) const
+{
+	// Written next to the target and renamed, so an interrupted job never
+	// leaves a truncated cache behind.
+	std::string temporary = path + ".tmp";
+
+	{
+		std::ofstream file(temporary.c_str(), std::ios::binary | std::ios::trunc);
+		FileHeader header;
+		header.magic = file_magic;
+		header.version = file_version;
+		header.parameters = m_parameters;
+		header.block_size = m_block_size;
+		header.blocks = m_cache.size();
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+		for (BlockMap::const_iterator it = m_cache.begin(); it != m_cache.end(); ++it) {
+			BlockHeader blockHeader;
+			blockHeader.hash = it->first;
+			blockHeader.count = it->second.count;
+			file.write(reinterpret_cast<const char*>(&blockHeader), sizeof(blockHeader));
+
+			for (size_t k = it->second.offset; k < it->second.offset + it->second.count; ++k) {
+				double values[2] = { m_output[k].x, m_output[k].y };
+				file.write(reinterpret_cast<const char*>(values), sizeof(values));
+			}
+		}
+
+		if (!file.flush()) {
+			std::remove(temporary.c_str());
+			return false;
+		}
+	}
+
+	// Renaming onto an existing file fails on some platforms.
+	if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+		std::remove(path.c_str());
+
+		if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+			std::remove(temporary.c_str());
+			return false;
+		}
+	}
+
+	return true;
+}
+
+} // namespace vti
@@ -0,0 +1,97 @@
+/*
+ * lazyposition.cpp
+ *
+ *  Created on: October 19, 2026
+ *      Author: Bjorn Blissing
+ */
+
+#include "lazyposition.h"
+#include "gausskreuger.h"
+
+namespace vti {
+
+LazyPosition::LazyPosition(const WGS84Position& position) :
+	m_sourceGrid(Position::Grid::WGS84),
+	m_source(0, position.getLatitude(), position.getLongitude())
+{
+}
+
+LazyPosition::LazyPosition(const RT90Position& position) :
+	m_sourceGrid(Position::Grid::RT90),
+	m_source(static_cast<int>(position.getProjection()), position.getLatitude(), position.getLongitude())
+{
+}
+
+LazyPosition::LazyPosition(const SWEREF99Position& position) :
+	m_sourceGrid(Position::Grid::SWEREF99),
+	m_source(static_cast<int>(position.getProjection()), position.getLatitude(), position.getLongitude())
+{
+}
+
+WGS84Position LazyPosition::toWGS84() const
+{
+	if (m_sourceGrid == Position::Grid::WGS84) {
+		return WGS84Position(m_source.x, m_source.y);
+	}
+
+	if (!m_wgs84.valid) {
+		const char* projectionName = m_sourceGrid == Position::Grid::RT90 ?
+									 RT90Position::getProjectionName(static_cast<RT90Position::RT90Projection>(m_source.projection)) :
+									 SWEREF99Position::getProjectionName(static_cast<SWEREF99Position::SWEREFProjection>(m_source.projection));
+		GaussKreuger gkProjection;
+		gkProjection.swedish_params(projectionName);
+		GaussKreuger::Coordinate lat_lon = gkProjection.grid_to_geodetic(m_source.x, m_source.y);
+		m_wgs84.x = lat_lon.x;
+		m_wgs84.y = lat_lon.y;
+		m_wgs84.valid = true;
+	}
+
+	return WGS84Position(m_wgs84.x, m_wgs84.y);
+}
+
+SWEREF99Position LazyPosition::toSWEREF99() const
+{
+	return toSWEREF99(SWEREF99Position::SWEREFProjection::sweref_99_tm);
+}
+
+SWEREF99Position LazyPosition::toSWEREF99(SWEREF99Position::SWEREFProjection projection) const
+{
+	if (m_sourceGrid == Position::Grid::SWEREF99 && m_source.projection == static_cast<int>(projection)) {
+		return SWEREF99Position(m_source.x, m_source.y, projection);
+	}
+
+	Cached& cache = projection == SWEREF99Position::SWEREFProjection::sweref_99_tm ? m_swerefTM : m_sweref;
+
+	if (!cache.valid || cache.projection != static_cast<int>(projection)) {
+		toGrid(SWEREF99Position::getProjectionName(projection), cache, static_cast<int>(projection));
+	}
+
+	return SWEREF99Position(cache.x, cache.y, projection);
+}
+
+RT90Position LazyPosition::toRT90(RT90Position::RT90Projection projection) const
+{
+	if (m_sourceGrid == Position::Grid::RT90 && m_source.projection == static_cast<int>(projection)) {
+		return RT90Position(m_source.x, m_source.y, projection);
+	}
+
+	if (!m_rt90.valid || m_rt90.projection != static_cast<int>(projection)) {
+		toGrid(RT90Position::getProjectionName(projection), m_rt90, static_cast<int>(projection));
+	}
+
+	return RT90Position(m_rt90.x, m_rt90.y, projection);
+}
+
+void LazyPosition::toGrid(const char* projectionName, Cached& cache, int projection) const
+{
+	WGS84Position wgs84 = toWGS84();
+	GaussKreuger gkProjection;
+	gkProjection.swedish_params(projectionName);
+	GaussKreuger::Coordinate x_y = gkProjection.geodetic_to_grid(wgs84.getLatitude(), wgs84.getLongitude());
+	cache.x = x_y.x;
+	cache.y = x_y.y;
+	cache.projection = projection;
+	cache.valid = true;
+}
+
+} // namespace vti
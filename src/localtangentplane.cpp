@@ -0,0 +1,132 @@
+/*
+ * localtangentplane.cpp
+ *
+ *  Created on: October 19, 2026
+ *      Author: Bjorn Blissing
+ */
+
+#include "localtangentplane.h"
+
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.1415926535897932384626433832
+#endif
+
+namespace vti {
+
+LocalTangentPlane::LocalTangentPlane(double latitude, double longitude, double height, const Ellipsoid& ellipsoid) : m_geocentric(ellipsoid)
+{
+	m_origin = m_geocentric.geodetic_to_geocentric(latitude, longitude, height);
+	double deg_to_rad = M_PI / 180.0;
+	double sin_phi = sin(latitude * deg_to_rad);
+	double cos_phi = cos(latitude * deg_to_rad);
+	double sin_lambda = sin(longitude * deg_to_rad);
+	double cos_lambda = cos(longitude * deg_to_rad);
+	// East.
+	m_rotation[0][0] = -sin_lambda;
+	m_rotation[0][1] = cos_lambda;
+	m_rotation[0][2] = 0.0;
+	// North.
+	m_rotation[1][0] = -sin_phi * cos_lambda;
+	m_rotation[1][1] = -sin_phi * sin_lambda;
+	m_rotation[1][2] = cos_phi;
+	// Up.
+	m_rotation[2][0] = cos_phi * cos_lambda;
+	m_rotation[2][1] = cos_phi * sin_lambda;
+	m_rotation[2][2] = sin_phi;
+}
+
+Geocentric::Cartesian LocalTangentPlane::geocentric_to_enu(const Geocentric::Cartesian& geocentric) const
+{
+	double dx = geocentric.x - m_origin.x;
+	double dy = geocentric.y - m_origin.y;
+	double dz = geocentric.z - m_origin.z;
+	Geocentric::Cartesian enu;
+	enu.x = m_rotation[0][0] * dx + m_rotation[0][1] * dy + m_rotation[0][2] * dz;
+	enu.y = m_rotation[1][0] * dx + m_rotation[1][1] * dy + m_rotation[1][2] * dz;
+	enu.z = m_rotation[2][0] * dx + m_rotation[2][1] * dy + m_rotation[2][2] * dz;
+	return enu;
+}
+
+Geocentric::Cartesian LocalTangentPlane::enu_to_geocentric(const Geocentric::Cartesian& enu) const
+{
+	// The rotation is orthonormal, so its inverse is the transpose.
+	Geocentric::Cartesian xyz;
+	xyz.x = m_rotation[0][0] * enu.x + m_rotation[1][0] * enu.y + m_rotation[2][0] * enu.z + m_origin.x;
+	xyz.y = m_rotation[0][1] * enu.x + m_rotation[1][1] * enu.y + m_rotation[2][1] * enu.z + m_origin.y;
+	xyz.z = m_rotation[0][2] * enu.x + m_rotation[1][2] * enu.y + m_rotation[2][2] * enu.z + m_origin.z;
+	return xyz;
+}
+
+Geocentric::Cartesian LocalTangentPlane::geodetic_to_enu(double latitude, double longitude, double height) const
+{
+	return geocentric_to_enu(m_geocentric.geodetic_to_geocentric(latitude, longitude, height));
+}
+
+Geocentric::Geodetic LocalTangentPlane::enu_to_geodetic(const Geocentric::Cartesian& enu) const
+{
+	return m_geocentric.geocentric_to_geodetic(enu_to_geocentric(enu));
+}
+
+void LocalTangentPlane::geocentric_to_enu(const Geocentric::Cartesian* geocentric, Geocentric::Cartesian* enu, size_t count) const
+{
+	for (size_t i = 0; i < count; ++i) {
+		enu[i] = geocentric_to_enu(geocentric[i]);
+	}
+}
+
+void LocalTangentPlane::enu_to_geocentric(const Geocentric::Cartesian* enu, Geocentric::Cartesian* geocentric, size_t count) const
+{
+	for (size_t i = 0; i < count; ++i) {
+		geocentric[i] = enu_to_geocentric(enu[i]);
+	}
+}
+
+void LocalTangentPlane::geodetic_to_enu(const Geocentric::Geodetic* geodetic, Geocentric::Cartesian* enu, size_t count) const
+{
+	for (size_t i = 0; i < count; ++i) {
+		enu[i] = geodetic_to_enu(geodetic[i].latitude, geodetic[i].longitude, geodetic[i].height);
+	}
+}
+
+void LocalTangentPlane::enu_to_geodetic(const Geocentric::Cartesian* enu, Geocentric::Geodetic* geodetic, size_t count) const
+{
+	for (size_t i = 0; i < count; ++i) {
+		geodetic[i] = enu_to_geodetic(enu[i]);
+	}
+}
+
+void LocalTangentPlane::grid_to_enu(const GaussKreuger& projection, const GaussKreuger::Coordinate* grid, const double* heights, Geocentric::Cartesian* enu, size_t count) const
+{
+	// Convert in chunks to get the batch conversion without allocating.
+	const size_t chunk = 64;
+	GaussKreuger::Coordinate lat_lon[chunk];
+
+	for (size_t begin = 0; begin < count; begin += chunk) {
+		size_t size = count - begin < chunk ? count - begin : chunk;
+		projection.grid_to_geodetic(grid + begin, lat_lon, size);
+
+		for (size_t i = 0; i < size; ++i) {
+			double height = heights ? heights[begin + i] : 0.0;
+			enu[begin + i] = geodetic_to_enu(lat_lon[i].x, lat_lon[i].y, height);
+		}
+	}
+}
+
+void LocalTangentPlane::enu_to_grid(const GaussKreuger& projection, const Geocentric::Cartesian* enu, GaussKreuger::Coordinate* grid, double* heights, size_t count) const
+{
+	for (size_t i = 0; i < count; ++i) {
+		Geocentric::Geodetic geodetic = enu_to_geodetic(enu[i]);
+		grid[i].x = geodetic.latitude;
+		grid[i].y = geodetic.longitude;
+
+		if (heights) {
+			heights[i] = geodetic.height;
+		}
+	}
+
+	projection.geodetic_to_grid(grid, grid, count);
+}
+
+} // namespace vti
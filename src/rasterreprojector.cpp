@@ -0,0 +1,183 @@
+/*
+ * rasterreprojector.cpp
+ *
+ *  Created on: October 19, 2026
+ *      Author: Bjorn Blissing
+ */
+
+#include "rasterreprojector.h"
+
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace vti {
+
+RasterReprojector::RasterReprojector(const RasterGrid& output, const GaussKreuger* outputProjection, const GaussKreuger* sourceProjection,
+									 double tolerance, size_t tileSize) :
+	m_output(output),
+	m_outputProjection(outputProjection),
+	m_sourceProjection(sourceProjection),
+	m_tolerance(tolerance),
+	m_tileSize(tileSize < 2 ? 2 : tileSize)
+{
+}
+
+GaussKreuger::Coordinate RasterReprojector::transform(const GaussKreuger::Coordinate& output) const
+{
+	GaussKreuger::Coordinate lat_lon = output;
+
+	if (m_outputProjection) {
+		lat_lon = m_outputProjection->grid_to_geodetic(output.x, output.y);
+	}
+
+	if (m_sourceProjection) {
+		return m_sourceProjection->geodetic_to_grid(lat_lon.x, lat_lon.y);
+	}
+
+	return lat_lon;
+}
+
+GaussKreuger::Coordinate RasterReprojector::transform_pixel(size_t row, size_t column) const
+{
+	return transform(m_output.pixel_centre(row, column));
+}
+
+size_t RasterReprojector::compute_rows(size_t rowBegin, size_t rowEnd, GaussKreuger::Coordinate* out) const
+{
+	size_t evaluations = 0;
+
+	if (rowEnd > m_output.rows) {
+		rowEnd = m_output.rows;
+	}
+
+	for (size_t row = rowBegin; row < rowEnd; row += m_tileSize) {
+		size_t tileRowEnd = row + m_tileSize < rowEnd ? row + m_tileSize : rowEnd;
+
+		for (size_t column = 0; column < m_output.columns; column += m_tileSize) {
+			size_t tileColumnEnd = column + m_tileSize < m_output.columns ? column + m_tileSize : m_output.columns;
+			evaluations += process_tile(row, column, tileRowEnd, tileColumnEnd, out);
+		}
+	}
+
+	return evaluations;
+}
+
+size_t RasterReprojector::compute(GaussKreuger::Coordinate* out, unsigned threads) const
+{
+	if (threads <= 1) {
+		return compute_rows(0, m_output.rows, out);
+	}
+
+	// Bands are whole multiples of the tile size, so the result does not
+	// depend on the number of threads.
+	size_t tileRows = (m_output.rows + m_tileSize - 1) / m_tileSize;
+	size_t tileRowsPerBand = (tileRows + threads - 1) / threads;
+	size_t bandRows = tileRowsPerBand * m_tileSize;
+	std::vector<size_t> evaluations(threads, 0);
+	std::vector<std::thread> workers;
+
+	for (unsigned i = 0; i < threads && i * bandRows < m_output.rows; ++i) {
+		workers.push_back(std::thread([this, i, bandRows, out, &evaluations]() {
+			evaluations[i] = compute_rows(i * bandRows, (i + 1) * bandRows, out);
+		}));
+	}
+
+	size_t total = 0;
+
+	for (size_t i = 0; i < workers.size(); ++i) {
+		workers[i].join();
+		total += evaluations[i];
+	}
+
+	return total;
+}
+
+size_t RasterReprojector::process_tile(size_t rowBegin, size_t columnBegin, size_t rowEnd, size_t columnEnd, GaussKreuger::Coordinate* out) const
+{
+	const size_t columns = m_output.columns;
+	const size_t rowLast = rowEnd - 1;
+	const size_t columnLast = columnEnd - 1;
+
+	// Small tiles are evaluated exactly.
+	if (rowEnd - rowBegin <= 2 && columnEnd - columnBegin <= 2) {
+		for (size_t row = rowBegin; row < rowEnd; ++row) {
+			for (size_t column = columnBegin; column < columnEnd; ++column) {
+				out[row * columns + column] = transform_pixel(row, column);
+			}
+		}
+
+		return (rowEnd - rowBegin) * (columnEnd - columnBegin);
+	}
+
+	// Control points at the corners.
+	GaussKreuger::Coordinate corners[4];
+	corners[0] = transform_pixel(rowBegin, columnBegin);
+	corners[1] = transform_pixel(rowBegin, columnLast);
+	corners[2] = transform_pixel(rowLast, columnBegin);
+	corners[3] = transform_pixel(rowLast, columnLast);
+	size_t evaluations = 4;
+	const double rowSpan = rowLast > rowBegin ? static_cast<double>(rowLast - rowBegin) : 1.0;
+	const double columnSpan = columnLast > columnBegin ? static_cast<double>(columnLast - columnBegin) : 1.0;
+
+	// Bilinear interpolation between the corners.
+	auto interpolate = [&corners](double u, double v) {
+		GaussKreuger::Coordinate result;
+		result.x = (1.0 - v) * ((1.0 - u) * corners[0].x + u * corners[1].x) + v * ((1.0 - u) * corners[2].x + u * corners[3].x);
+		result.y = (1.0 - v) * ((1.0 - u) * corners[0].y + u * corners[1].y) + v * ((1.0 - u) * corners[2].y + u * corners[3].y);
+		return result;
+	};
+
+	// Check the error at the centre and the edge midpoints.
+	const size_t rowMiddle = (rowBegin + rowLast) / 2;
+	const size_t columnMiddle = (columnBegin + columnLast) / 2;
+	const size_t checkRows[5] = { rowMiddle, rowBegin, rowLast, rowMiddle, rowMiddle };
+	const size_t checkColumns[5] = { columnMiddle, columnMiddle, columnMiddle, columnBegin, columnLast };
+	bool withinTolerance = true;
+
+	for (int i = 0; i < 5 && withinTolerance; ++i) {
+		GaussKreuger::Coordinate exact = transform_pixel(checkRows[i], checkColumns[i]);
+		GaussKreuger::Coordinate approximation = interpolate((checkColumns[i] - columnBegin) / columnSpan, (checkRows[i] - rowBegin) / rowSpan);
+		++evaluations;
+		withinTolerance = fabs(exact.x - approximation.x) <= m_tolerance && fabs(exact.y - approximation.y) <= m_tolerance;
+	}
+
+	if (!withinTolerance) {
+		// Split in four and try again.
+		const size_t rowSplit = rowBegin + (rowEnd - rowBegin + 1) / 2;
+		const size_t columnSplit = columnBegin + (columnEnd - columnBegin + 1) / 2;
+		evaluations += process_tile(rowBegin, columnBegin, rowSplit, columnSplit, out);
+
+		if (columnSplit < columnEnd) {
+			evaluations += process_tile(rowBegin, columnSplit, rowSplit, columnEnd, out);
+		}
+
+		if (rowSplit < rowEnd) {
+			evaluations += process_tile(rowSplit, columnBegin, rowEnd, columnSplit, out);
+
+			if (columnSplit < columnEnd) {
+				evaluations += process_tile(rowSplit, columnSplit, rowEnd, columnEnd, out);
+			}
+		}
+
+		return evaluations;
+	}
+
+	for (size_t row = rowBegin; row < rowEnd; ++row) {
+		const double v = (row - rowBegin) / rowSpan;
+		GaussKreuger::Coordinate* line = out + row * columns;
+
+		for (size_t column = columnBegin; column < columnEnd; ++column) {
+			line[column] = interpolate((column - columnBegin) / columnSpan, v);
+		}
+	}
+
+	// Keep the exactly evaluated corners.
+	out[rowBegin * columns + columnBegin] = corners[0];
+	out[rowBegin * columns + columnLast] = corners[1];
+	out[rowLast * columns + columnBegin] = corners[2];
+	out[rowLast * columns + columnLast] = corners[3];
+	return evaluations;
+}
+
+} // namespace vti
@@ -10,20 +10,20 @@
 
 namespace vti {
 
-RT90Position::RT90Position(WGS84Position position, RT90Projection rt90projection) : Position(Grid::RT90)
+RT90Position::RT90Position(WGS84Position position, RT90Projection rt90projection) noexcept : Position(Grid::RT90)
 {
 	GaussKreuger gkProjection;
-	gkProjection.swedish_params(getProjectionString(rt90projection));
+	gkProjection.swedish_params(getProjectionName(rt90projection));
 	GaussKreuger::Coordinate lat_lon = gkProjection.geodetic_to_grid(position.getLatitude(), position.getLongitude());
 	m_latitude = lat_lon.x;
 	m_longitude = lat_lon.y;
 	m_projection = rt90projection;
 }
 
-WGS84Position RT90Position::toWGS84()
+WGS84Position RT90Position::toWGS84() const noexcept
 {
 	GaussKreuger gkProjection;
-	gkProjection.swedish_params(getProjectionString());
+	gkProjection.swedish_params(getProjectionName(m_projection));
 	GaussKreuger::Coordinate lat_lon = gkProjection.grid_to_geodetic(m_latitude, m_longitude);
 	WGS84Position newPos(lat_lon.x, lat_lon.y);
 	return newPos;
@@ -31,7 +31,12 @@ WGS84Position RT90Position::toWGS84()
 
 std::string RT90Position::getProjectionString(RT90Projection projection)
 {
-	std::string retVal = "";
+	return getProjectionName(projection);
+}
+
+const char* RT90Position::getProjectionName(RT90Projection projection) noexcept
+{
+	const char* retVal = "";
 
 	switch (projection) {
 		case RT90Projection::rt90_7_5_gon_v:
@@ -0,0 +1,246 @@
+/*
+ * spatialindex.cpp
+ *
+ *  Created on: October 19, 2026
+ *      Author: Bjorn Blissing
+ */
+
+#include "spatialindex.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace vti {
+
+namespace {
+
+double axisValue(const GaussKreuger::Coordinate& point, int axis)
+{
+	return axis == 0 ? point.x : point.y;
+}
+
+double squaredDistance(const GaussKreuger::Coordinate& a, const GaussKreuger::Coordinate& b)
+{
+	return (a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y);
+}
+
+// Max-heap on distance, so the worst of the current k candidates is on top.
+bool closer(const SpatialIndex::Neighbour& a, const SpatialIndex::Neighbour& b)
+{
+	return a.distance < b.distance;
+}
+
+} // namespace
+
+SpatialIndex::SpatialIndex(const GaussKreuger& projection, const GaussKreuger::Coordinate* grid, size_t count) :
+	m_projection(projection), m_nodes(count)
+{
+	for (size_t i = 0; i < count; ++i) {
+		m_nodes[i].point = grid[i];
+		m_nodes[i].index = i;
+	}
+
+	build(0, count, 0);
+}
+
+SpatialIndex SpatialIndex::from_geodetic(const GaussKreuger& projection, const GaussKreuger::Coordinate* geodetic, size_t count)
+{
+	std::vector<GaussKreuger::Coordinate> grid(count);
+
+	if (count) {
+		projection.geodetic_to_grid(geodetic, &grid[0], count);
+	}
+
+	return SpatialIndex(projection, count ? &grid[0] : nullptr, count);
+}
+
+void SpatialIndex::build(size_t begin, size_t end, int axis)
+{
+	if (end - begin <= 1) {
+		return;
+	}
+
+	size_t middle = begin + (end - begin) / 2;
+	std::nth_element(m_nodes.begin() + begin, m_nodes.begin() + middle, m_nodes.begin() + end,
+	[axis](const Node & a, const Node & b) {
+		return axisValue(a.point, axis) < axisValue(b.point, axis);
+	});
+	build(begin, middle, 1 - axis);
+	build(middle + 1, end, 1 - axis);
+}
+
+void SpatialIndex::ScaleModel::range(double distance, double& minimum, double& maximum) const
+{
+	double low = midpoint(easting - distance);
+	double high = midpoint(easting + distance);
+	minimum = low < high ? low : high;
+	maximum = low > high ? low : high;
+	// The scale factor is smallest on the central meridian.
+	double vertex = curvature > 0.0 ? -slope / curvature : 0.0;
+
+	if (curvature > 0.0 && fabs(vertex) < distance / 2.0) {
+		double bottom = scale + 0.5 * slope * vertex;
+		minimum = bottom < minimum ? bottom : minimum;
+	}
+
+	minimum = scale < minimum ? scale : minimum;
+	maximum = scale > maximum ? scale : maximum;
+}
+
+SpatialIndex::ScaleModel SpatialIndex::scale_model(double latitude, double longitude, const GaussKreuger::Coordinate& grid) const
+{
+	const double step = 1000.0;
+	GaussKreuger::Coordinate east = m_projection.grid_to_geodetic(grid.x, grid.y + step);
+	GaussKreuger::Coordinate west = m_projection.grid_to_geodetic(grid.x, grid.y - step);
+	double eastScale = m_projection.scale_factor(east.x, east.y);
+	double westScale = m_projection.scale_factor(west.x, west.y);
+	ScaleModel model;
+	model.easting = grid.y;
+	model.scale = m_projection.scale_factor(latitude, longitude);
+	model.slope = (eastScale - westScale) / (2.0 * step);
+	model.curvature = (eastScale - 2.0 * model.scale + westScale) / (step * step);
+	return model;
+}
+
+void SpatialIndex::radius_search(double latitude, double longitude, double radius, std::vector<Neighbour>& result) const
+{
+	GaussKreuger::Coordinate grid = m_projection.geodetic_to_grid(latitude, longitude);
+	radius_search(grid, radius, scale_model(latitude, longitude, grid), result);
+}
+
+void SpatialIndex::nearest(double latitude, double longitude, size_t k, std::vector<Neighbour>& result) const
+{
+	GaussKreuger::Coordinate grid = m_projection.geodetic_to_grid(latitude, longitude);
+	nearest(grid, k, scale_model(latitude, longitude, grid), result);
+}
+
+void SpatialIndex::radius_search_grid(const GaussKreuger::Coordinate& grid, double radius, double scale, std::vector<Neighbour>& result) const
+{
+	ScaleModel model;
+	model.easting = grid.y;
+	model.scale = scale;
+	model.slope = 0.0;
+	model.curvature = 0.0;
+	radius_search(grid, radius, model, result);
+}
+
+void SpatialIndex::nearest_grid(const GaussKreuger::Coordinate& grid, size_t k, double scale, std::vector<Neighbour>& result) const
+{
+	ScaleModel model;
+	model.easting = grid.y;
+	model.scale = scale;
+	model.slope = 0.0;
+	model.curvature = 0.0;
+	nearest(grid, k, model, result);
+}
+
+void SpatialIndex::radius_search(const GaussKreuger::Coordinate& grid, double radius, const ScaleModel& model, std::vector<Neighbour>& result) const
+{
+	result.clear();
+	// Search the grid with the largest scale factor in reach, then keep the
+	// points within radius at their own scale factor. The scale factor is
+	// close to one, so twice the radius bounds the grid distance.
+	double minimum = 0.0;
+	double maximum = 0.0;
+	model.range(2.0 * radius, minimum, maximum);
+	double gridRadius = radius * maximum;
+	radius_search(0, m_nodes.size(), 0, grid, gridRadius * gridRadius, model, radius, result);
+	std::sort(result.begin(), result.end(), closer);
+}
+
+void SpatialIndex::nearest(const GaussKreuger::Coordinate& grid, size_t k, const ScaleModel& model, std::vector<Neighbour>& result) const
+{
+	result.clear();
+
+	if (k == 0 || m_nodes.empty()) {
+		return;
+	}
+
+	// The k nearest in grid distance bound the distance of the k nearest on
+	// the ellipsoid. Collect everything within that bound and keep the k
+	// nearest by their own scale factor.
+	std::vector<Neighbour> heap;
+	heap.reserve(k);
+	nearest(0, m_nodes.size(), 0, grid, k, heap);
+	double gridDistance = sqrt(heap.front().distance);
+	double minimum = 0.0;
+	double maximum = 0.0;
+	model.range(gridDistance, minimum, maximum);
+	// A micrometre more, so rounding can not drop the k-th point.
+	radius_search(grid, gridDistance / minimum + 1e-6, model, result);
+
+	if (result.size() > k) {
+		result.resize(k);
+	}
+}
+
+// The recursive searches work on squared grid distances.
+void SpatialIndex::radius_search(size_t begin, size_t end, int axis, const GaussKreuger::Coordinate& query, double radius2,
+								 const ScaleModel& model, double radius, std::vector<Neighbour>& result) const
+{
+	while (begin < end) {
+		size_t middle = begin + (end - begin) / 2;
+		const Node& node = m_nodes[middle];
+		double distance2 = squaredDistance(node.point, query);
+
+		if (distance2 <= radius2) {
+			double distance = sqrt(distance2) / model.midpoint(node.point.y);
+
+			if (distance <= radius) {
+				result.push_back(Neighbour(node.index, distance));
+			}
+		}
+
+		double diff = axisValue(query, axis) - axisValue(node.point, axis);
+		size_t nearBegin = diff < 0.0 ? begin : middle + 1;
+		size_t nearEnd = diff < 0.0 ? middle : end;
+
+		if (diff * diff <= radius2) {
+			// Both sides may contain hits. Recurse on one, loop on the other.
+			radius_search(diff < 0.0 ? middle + 1 : begin, diff < 0.0 ? end : middle, 1 - axis, query, radius2, model, radius, result);
+		}
+
+		begin = nearBegin;
+		end = nearEnd;
+		axis = 1 - axis;
+	}
+}
+
+void SpatialIndex::nearest(size_t begin, size_t end, int axis, const GaussKreuger::Coordinate& query, size_t k, std::vector<Neighbour>& heap) const
+{
+	if (begin >= end) {
+		return;
+	}
+
+	size_t middle = begin + (end - begin) / 2;
+	const Node& node = m_nodes[middle];
+	double distance2 = squaredDistance(node.point, query);
+
+	if (heap.size() < k) {
+		heap.push_back(Neighbour(node.index, distance2));
+		std::push_heap(heap.begin(), heap.end(), closer);
+	} else if (distance2 < heap.front().distance) {
+		std::pop_heap(heap.begin(), heap.end(), closer);
+		heap.back() = Neighbour(node.index, distance2);
+		std::push_heap(heap.begin(), heap.end(), closer);
+	}
+
+	double diff = axisValue(query, axis) - axisValue(node.point, axis);
+
+	if (diff < 0.0) {
+		nearest(begin, middle, 1 - axis, query, k, heap);
+	} else {
+		nearest(middle + 1, end, 1 - axis, query, k, heap);
+	}
+
+	// Visit the far side only if it can hold something closer.
+	if (heap.size() < k || diff * diff < heap.front().distance) {
+		if (diff < 0.0) {
+			nearest(middle + 1, end, 1 - axis, query, k, heap);
+		} else {
+			nearest(begin, middle, 1 - axis, query, k, heap);
+		}
+	}
+}
+
+} // namespace vti
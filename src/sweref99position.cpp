@@ -10,20 +10,20 @@
 
 namespace vti {
 
-SWEREF99Position::SWEREF99Position(WGS84Position position, SWEREFProjection projection) : Position(Grid::SWEREF99)
+SWEREF99Position::SWEREF99Position(WGS84Position position, SWEREFProjection projection) noexcept : Position(Grid::SWEREF99)
 {
 	GaussKreuger gkProjection;
-	gkProjection.swedish_params(getProjectionString(projection));
+	gkProjection.swedish_params(getProjectionName(projection));
 	GaussKreuger::Coordinate lat_lon = gkProjection.geodetic_to_grid(position.getLatitude(), position.getLongitude());
 	m_latitude = lat_lon.x;
 	m_longitude = lat_lon.y;
 	m_projection = projection;
 }
 
-WGS84Position SWEREF99Position::toWGS84()
+WGS84Position SWEREF99Position::toWGS84() const noexcept
 {
 	GaussKreuger gkProjection;
-	gkProjection.swedish_params(getProjectionString(m_projection));
+	gkProjection.swedish_params(getProjectionName(m_projection));
 	GaussKreuger::Coordinate lat_lon = gkProjection.grid_to_geodetic(m_latitude, m_longitude);
 	WGS84Position newPos(lat_lon.x, lat_lon.y);
 	return newPos;
@@ -31,7 +31,12 @@ WGS84Position SWEREF99Position::toWGS84()
 
 std::string SWEREF99Position::getProjectionString(SWEREFProjection projection)
 {
-	std::string retVal = "";
+	return getProjectionName(projection);
+}
+
+const char* SWEREF99Position::getProjectionName(SWEREFProjection projection) noexcept
+{
+	const char* retVal = "";
 
 	switch (projection) {
 		case SWEREFProjection::sweref_99_tm:
@@ -0,0 +1,257 @@
+/*
+ * trajectorycodec.cpp
+ *
+ *  Created on: October 19, 2026
+ *      Author: Bjorn Blissing
+ */
+
+#include "trajectorycodec.h"
+
+#include <cmath>
+#include <cstdint>
+
+namespace vti {
+
+namespace {
+
+void putVarint(std::vector<unsigned char>& buffer, uint64_t value)
+{
+	while (value >= 0x80) {
+		buffer.push_back(static_cast<unsigned char>(value | 0x80));
+		value >>= 7;
+	}
+
+	buffer.push_back(static_cast<unsigned char>(value));
+}
+
+// Returns false on truncated or overlong input.
+bool getVarint(const unsigned char*& pos, const unsigned char* end, uint64_t& value)
+{
+	value = 0;
+
+	for (unsigned shift = 0; shift < 64 && pos < end; shift += 7) {
+		unsigned char byte = *pos++;
+		value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+
+		if (!(byte & 0x80)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+uint64_t zigzag(int64_t value)
+{
+	return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t unzigzag(uint64_t value)
+{
+	return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+// True if [pos, end) holds exactly count coordinate pairs.
+bool checkBlock(const unsigned char* pos, const unsigned char* end, uint64_t count)
+{
+	uint64_t value = 0;
+
+	for (uint64_t i = 0; i < 2 * count; ++i) {
+		if (!getVarint(pos, end, value)) {
+			return false;
+		}
+	}
+
+	return pos == end;
+}
+
+int64_t toMillimetres(double value)
+{
+	return static_cast<int64_t>(llround(value * 1000.0));
+}
+
+} // namespace
+
+void TrajectoryCodec::encode(const GaussKreuger::Coordinate* coordinates, size_t count, size_t block_size)
+{
+	if (block_size == 0) {
+		block_size = 1;
+	}
+
+	m_count = count;
+	m_block_size = block_size;
+	m_data.clear();
+	m_offsets.clear();
+	// Encode the blocks first, then prepend the header with their lengths.
+	std::vector<unsigned char> payload;
+	std::vector<size_t> lengths;
+
+	for (size_t begin = 0; begin < count; begin += block_size) {
+		size_t end = begin + block_size < count ? begin + block_size : count;
+		size_t blockStart = payload.size();
+		int64_t previousX = 0;
+		int64_t previousY = 0;
+
+		for (size_t i = begin; i < end; ++i) {
+			int64_t x = toMillimetres(coordinates[i].x);
+			int64_t y = toMillimetres(coordinates[i].y);
+			putVarint(payload, zigzag(x - previousX));
+			putVarint(payload, zigzag(y - previousY));
+			previousX = x;
+			previousY = y;
+		}
+
+		lengths.push_back(payload.size() - blockStart);
+	}
+
+	putVarint(m_data, m_count);
+	putVarint(m_data, m_block_size);
+
+	for (size_t i = 0; i < lengths.size(); ++i) {
+		putVarint(m_data, lengths[i]);
+	}
+
+	size_t offset = m_data.size();
+	m_data.insert(m_data.end(), payload.begin(), payload.end());
+
+	for (size_t i = 0; i < lengths.size(); ++i) {
+		m_offsets.push_back(offset);
+		offset += lengths[i];
+	}
+
+	m_offsets.push_back(offset);
+}
+
+void TrajectoryCodec::encode(const std::vector<GaussKreuger::Coordinate>& coordinates, size_t block_size)
+{
+	encode(coordinates.empty() ? nullptr : &coordinates[0], coordinates.size(), block_size);
+}
+
+bool TrajectoryCodec::load(const unsigned char* data, size_t size)
+{
+	m_count = 0;
+	m_block_size = 0;
+	m_data.clear();
+	m_offsets.clear();
+	const unsigned char* pos = data;
+	const unsigned char* end = data + size;
+	uint64_t count = 0;
+	uint64_t blockSize = 0;
+
+	if (!getVarint(pos, end, count) || !getVarint(pos, end, blockSize) || blockSize == 0) {
+		return false;
+	}
+
+	uint64_t blocks = count / blockSize + (count % blockSize ? 1 : 0);
+
+	if (blocks > size) {
+		return false;
+	}
+
+	std::vector<uint64_t> lengths(static_cast<size_t>(blocks));
+
+	for (size_t i = 0; i < lengths.size(); ++i) {
+		if (!getVarint(pos, end, lengths[i])) {
+			return false;
+		}
+	}
+
+	size_t offset = static_cast<size_t>(pos - data);
+	std::vector<size_t> offsets;
+
+	for (size_t i = 0; i < lengths.size(); ++i) {
+		offsets.push_back(offset);
+		uint64_t expected = count - i * blockSize < blockSize ? count - i * blockSize : blockSize;
+
+		// Every coordinate takes at least two bytes, which bounds count by the
+		// size of the input before anything is allocated from it.
+		if (lengths[i] > size - offset || lengths[i] < 2 * expected ||
+			!checkBlock(data + offset, data + offset + lengths[i], expected)) {
+			return false;
+		}
+
+		offset += static_cast<size_t>(lengths[i]);
+	}
+
+	offsets.push_back(offset);
+	m_count = static_cast<size_t>(count);
+	// A single block never needs more room than the whole trajectory.
+	m_block_size = static_cast<size_t>(blockSize < count ? blockSize : (count ? count : 1));
+	m_data.assign(data, data + offset);
+	m_offsets.swap(offsets);
+	return true;
+}
+
+size_t TrajectoryCodec::decode_block(size_t block, GaussKreuger::Coordinate* out) const
+{
+	if (block >= block_count()) {
+		return 0;
+	}
+
+	size_t expected = m_count - block * m_block_size;
+
+	if (expected > m_block_size) {
+		expected = m_block_size;
+	}
+
+	const unsigned char* pos = &m_data[0] + m_offsets[block];
+	const unsigned char* end = &m_data[0] + m_offsets[block + 1];
+	int64_t x = 0;
+	int64_t y = 0;
+	size_t decoded = 0;
+
+	while (decoded < expected) {
+		uint64_t deltaX = 0;
+		uint64_t deltaY = 0;
+
+		if (!getVarint(pos, end, deltaX) || !getVarint(pos, end, deltaY)) {
+			return 0;
+		}
+
+		x += unzigzag(deltaX);
+		y += unzigzag(deltaY);
+		out[decoded].x = x / 1000.0;
+		out[decoded].y = y / 1000.0;
+		++decoded;
+	}
+
+	return decoded;
+}
+
+size_t TrajectoryCodec::decode_block_to_geodetic(size_t block, const GaussKreuger& projection, GaussKreuger::Coordinate* out) const
+{
+	size_t decoded = decode_block(block, out);
+	projection.grid_to_geodetic(out, out, decoded);
+	return decoded;
+}
+
+std::vector<GaussKreuger::Coordinate> TrajectoryCodec::decode() const
+{
+	std::vector<GaussKreuger::Coordinate> coordinates(m_count);
+	size_t written = 0;
+
+	for (size_t block = 0; block < block_count(); ++block) {
+		size_t expected = m_count - written < m_block_size ? m_count - written : m_block_size;
+
+		if (decode_block(block, &coordinates[written]) != expected) {
+			return std::vector<GaussKreuger::Coordinate>();
+		}
+
+		written += expected;
+	}
+
+	return coordinates;
+}
+
+std::vector<GaussKreuger::Coordinate> TrajectoryCodec::decode_to_geodetic(const GaussKreuger& projection) const
+{
+	std::vector<GaussKreuger::Coordinate> coordinates = decode();
+
+	if (!coordinates.empty()) {
+		projection.grid_to_geodetic(&coordinates[0], &coordinates[0], coordinates.size());
+	}
+
+	return coordinates;
+}
+
+} // namespace vti
@@ -0,0 +1,211 @@
+/*
+ * trajectorysimplifier.cpp
+ *
+ *  Created on: October 19, 2026
+ *      Author: Bjorn Blissing
+ */
+
+#include "trajectorysimplifier.h"
+
+#include <cmath>
+#include <utility>
+
+#ifndef M_PI
+#define M_PI 3.1415926535897932384626433832
+#endif
+
+namespace vti {
+
+namespace {
+
+const double earth_radius = 6371000.0;
+const double metres_per_degree = 111320.0;
+// Finite difference step for the Jacobian, degrees.
+const double jacobian_step = 1e-3;
+// Blocks never grow longer than this, metres.
+const double max_block_length = 2000.0;
+// Grid coordinates are rounded to millimetres.
+const double rounding = 0.0005;
+
+// Distance from p to the segment a-b.
+double segmentDistance(const GaussKreuger::Coordinate& p, const GaussKreuger::Coordinate& a, const GaussKreuger::Coordinate& b)
+{
+	double dx = b.x - a.x;
+	double dy = b.y - a.y;
+	double length2 = dx * dx + dy * dy;
+	double t = length2 > 0.0 ? ((p.x - a.x) * dx + (p.y - a.y) * dy) / length2 : 0.0;
+	t = t < 0.0 ? 0.0 : (t > 1.0 ? 1.0 : t);
+	double ex = p.x - (a.x + t * dx);
+	double ey = p.y - (a.y + t * dy);
+	return sqrt(ex * ex + ey * ey);
+}
+
+} // namespace
+
+const GaussKreuger::Coordinate& TrajectorySimplifier::exact(const GaussKreuger::Coordinate* geodetic, size_t index)
+{
+	if (!m_projected[index]) {
+		m_exact[index] = m_projection.geodetic_to_grid(geodetic[index].x, geodetic[index].y);
+		m_projected[index] = 1;
+		++m_projections;
+	}
+
+	return m_exact[index];
+}
+
+// Affine approximation of every point, block by block. The second derivatives
+// of a transverse Mercator projection, in metres per metre squared, are bounded
+// by about (1 + |tan(latitude)|) / R, which gives the error bound below with a
+// safety factor of two. The finite difference Jacobian adds its truncation
+// error and the effect of the millimetre rounding of the differenced points.
+void TrajectorySimplifier::approximate(const GaussKreuger::Coordinate* geodetic, size_t count, double tolerance)
+{
+	double deg_to_rad = M_PI / 180.0;
+	size_t anchor = 0;
+
+	while (anchor < count) {
+		const GaussKreuger::Coordinate& origin = geodetic[anchor];
+		double cos_lat = cos(origin.x * deg_to_rad);
+		double curvature = 2.0 * (1.0 + fabs(tan(origin.x * deg_to_rad))) / earth_radius;
+		// Longest block where the approximation error stays below a quarter of the tolerance.
+		double length = sqrt(tolerance / (4.0 * curvature));
+		length = length < max_block_length ? length : max_block_length;
+
+		const GaussKreuger::Coordinate& base = exact(geodetic, anchor);
+		GaussKreuger::Coordinate north = m_projection.geodetic_to_grid(origin.x + jacobian_step, origin.y);
+		GaussKreuger::Coordinate east = m_projection.geodetic_to_grid(origin.x, origin.y + jacobian_step);
+		m_projections += 2;
+		// Grid metres per degree of latitude and longitude.
+		double j00 = (north.x - base.x) / jacobian_step;
+		double j10 = (north.y - base.y) / jacobian_step;
+		double j01 = (east.x - base.x) / jacobian_step;
+		double j11 = (east.y - base.y) / jacobian_step;
+		double step = jacobian_step * metres_per_degree * cos_lat; // Shortest difference step, metres.
+		size_t end = anchor;
+
+		while (end < count) {
+			double dlat = geodetic[end].x - origin.x;
+			double dlon = geodetic[end].y - origin.y;
+			double north_m = dlat * metres_per_degree;
+			double east_m = dlon * metres_per_degree * cos_lat;
+			// Slightly generous, the metres per degree above are approximate.
+			double distance = 1.01 * sqrt(north_m * north_m + east_m * east_m);
+
+			if (distance > length && end > anchor) {
+				break;
+			}
+
+			m_approximate[end].x = base.x + j00 * dlat + j01 * dlon;
+			m_approximate[end].y = base.y + j10 * dlat + j11 * dlon;
+			m_bound[end] = curvature * distance * (distance + step) + 4.0 * rounding * distance / step + rounding;
+			++end;
+		}
+
+		anchor = end;
+	}
+}
+
+void TrajectorySimplifier::simplify(const GaussKreuger::Coordinate* geodetic, size_t count, double tolerance,
+									std::vector<GaussKreuger::Coordinate>& grid, std::vector<size_t>* indices)
+{
+	grid.clear();
+
+	if (indices) {
+		indices->clear();
+	}
+
+	m_projections = 0;
+
+	if (count == 0) {
+		return;
+	}
+
+	m_exact.assign(count, GaussKreuger::Coordinate());
+	m_projected.assign(count, 0);
+	m_approximate.resize(count);
+	m_bound.resize(count);
+	m_keep.assign(count, 0);
+	approximate(geodetic, count, tolerance > 0.0 ? tolerance : 0.001);
+	m_keep[0] = 1;
+	m_keep[count - 1] = 1;
+
+	std::vector<std::pair<size_t, size_t> > stack;
+
+	if (count > 2) {
+		stack.push_back(std::make_pair(size_t(0), count - 1));
+	}
+
+	std::vector<size_t> candidates;
+
+	while (!stack.empty()) {
+		size_t first = stack.back().first;
+		size_t last = stack.back().second;
+		stack.pop_back();
+		const GaussKreuger::Coordinate a = exact(geodetic, first);
+		const GaussKreuger::Coordinate b = exact(geodetic, last);
+		// The true distance of each point lies within its bound of the
+		// approximate distance. lower is a lower bound of the true maximum.
+		double lower = 0.0;
+		double upper = 0.0;
+
+		for (size_t k = first + 1; k < last; ++k) {
+			double distance = segmentDistance(m_projected[k] ? m_exact[k] : m_approximate[k], a, b);
+			double bound = m_projected[k] ? 0.0 : m_bound[k];
+			lower = distance - bound > lower ? distance - bound : lower;
+			upper = distance + bound > upper ? distance + bound : upper;
+		}
+
+		if (upper <= tolerance) {
+			continue;
+		}
+
+		// Only points that may be the farthest and beyond the tolerance are projected.
+		candidates.clear();
+		double threshold = lower > tolerance ? lower : tolerance;
+
+		for (size_t k = first + 1; k < last; ++k) {
+			double distance = segmentDistance(m_projected[k] ? m_exact[k] : m_approximate[k], a, b);
+			double bound = m_projected[k] ? 0.0 : m_bound[k];
+
+			if (distance + bound >= threshold) {
+				candidates.push_back(k);
+			}
+		}
+
+		size_t farthest = first;
+		double maximum = 0.0;
+
+		for (size_t i = 0; i < candidates.size(); ++i) {
+			double distance = segmentDistance(exact(geodetic, candidates[i]), a, b);
+
+			if (distance > maximum) {
+				maximum = distance;
+				farthest = candidates[i];
+			}
+		}
+
+		if (maximum > tolerance) {
+			m_keep[farthest] = 1;
+
+			if (farthest - first > 1) {
+				stack.push_back(std::make_pair(first, farthest));
+			}
+
+			if (last - farthest > 1) {
+				stack.push_back(std::make_pair(farthest, last));
+			}
+		}
+	}
+
+	for (size_t i = 0; i < count; ++i) {
+		if (m_keep[i]) {
+			grid.push_back(exact(geodetic, i));
+
+			if (indices) {
+				indices->push_back(i);
+			}
+		}
+	}
+}
+
+} // namespace vti
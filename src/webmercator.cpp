@@ -0,0 +1,176 @@
+/*
+ * webmercator.cpp
+ *
+ *  Created on: October 19, 2026
+ *      Author: Bjorn Blissing
+ */
+
+#include "webmercator.h"
+
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.1415926535897932384626433832
+#endif
+
+namespace vti {
+
+namespace {
+
+const double radius = 6378137.0; // Sphere radius of Web Mercator.
+const double max_latitude = 85.051128779806592; // atan(sinh(pi)) in degrees.
+// Number of points converted per chunk in the fused grid conversions.
+const size_t chunk_size = 256;
+
+double clampLatitude(double latitude)
+{
+	return latitude > max_latitude ? max_latitude : (latitude < -max_latitude ? -max_latitude : latitude);
+}
+
+uint32_t clampZoom(uint32_t zoom)
+{
+	return zoom > WebMercator::max_zoom ? WebMercator::max_zoom : zoom;
+}
+
+uint32_t clampTile(double value, uint32_t tiles)
+{
+	if (!(value >= 0.0)) {
+		return 0;
+	}
+
+	return value >= tiles ? tiles - 1 : static_cast<uint32_t>(value);
+}
+
+} // namespace
+
+const uint32_t WebMercator::max_zoom;
+
+GaussKreuger::Coordinate WebMercator::geodetic_to_mercator(double latitude, double longitude)
+{
+	double deg_to_rad = M_PI / 180.0;
+	double phi = clampLatitude(latitude) * deg_to_rad;
+	GaussKreuger::Coordinate x_y;
+	x_y.x = radius * log(tan(M_PI / 4.0 + phi / 2.0));
+	x_y.y = radius * longitude * deg_to_rad;
+	return x_y;
+}
+
+GaussKreuger::Coordinate WebMercator::mercator_to_geodetic(double x, double y)
+{
+	double rad_to_deg = 180.0 / M_PI;
+	GaussKreuger::Coordinate lat_lon;
+	lat_lon.x = atan(sinh(x / radius)) * rad_to_deg;
+	lat_lon.y = y / radius * rad_to_deg;
+	return lat_lon;
+}
+
+WebMercator::TileKey WebMercator::geodetic_to_tile(double latitude, double longitude, uint32_t zoom)
+{
+	double deg_to_rad = M_PI / 180.0;
+	double phi = clampLatitude(latitude) * deg_to_rad;
+	zoom = clampZoom(zoom);
+	uint32_t tiles = 1u << zoom;
+	TileKey tile;
+	tile.x = clampTile((longitude + 180.0) / 360.0 * tiles, tiles);
+	tile.y = clampTile((1.0 - log(tan(phi) + 1.0 / cos(phi)) / M_PI) / 2.0 * tiles, tiles);
+	tile.zoom = zoom;
+	return tile;
+}
+
+void WebMercator::geodetic_to_mercator(const GaussKreuger::Coordinate* geodetic, GaussKreuger::Coordinate* mercator, size_t count)
+{
+	for (size_t i = 0; i < count; ++i) {
+		mercator[i] = geodetic_to_mercator(geodetic[i].x, geodetic[i].y);
+	}
+}
+
+void WebMercator::mercator_to_geodetic(const GaussKreuger::Coordinate* mercator, GaussKreuger::Coordinate* geodetic, size_t count)
+{
+	for (size_t i = 0; i < count; ++i) {
+		geodetic[i] = mercator_to_geodetic(mercator[i].x, mercator[i].y);
+	}
+}
+
+void WebMercator::geodetic_to_tile(const GaussKreuger::Coordinate* geodetic, TileKey* tiles, size_t count, uint32_t zoom)
+{
+	for (size_t i = 0; i < count; ++i) {
+		tiles[i] = geodetic_to_tile(geodetic[i].x, geodetic[i].y, zoom);
+	}
+}
+
+void WebMercator::grid_to_mercator(const GaussKreuger& projection, const GaussKreuger::Coordinate* grid, GaussKreuger::Coordinate* mercator, size_t count)
+{
+	projection.grid_to_geodetic(grid, mercator, count);
+	geodetic_to_mercator(mercator, mercator, count);
+}
+
+void WebMercator::grid_to_tile(const GaussKreuger& projection, const GaussKreuger::Coordinate* grid, TileKey* tiles, size_t count, uint32_t zoom)
+{
+	GaussKreuger::Coordinate lat_lon[chunk_size];
+
+	for (size_t begin = 0; begin < count; begin += chunk_size) {
+		size_t size = count - begin < chunk_size ? count - begin : chunk_size;
+		projection.grid_to_geodetic(grid + begin, lat_lon, size);
+		geodetic_to_tile(lat_lon, tiles + begin, size, zoom);
+	}
+}
+
+void WebMercator::grid_to_quadkey(const GaussKreuger& projection, const GaussKreuger::Coordinate* grid, uint64_t* quadkeys, size_t count, uint32_t zoom)
+{
+	GaussKreuger::Coordinate lat_lon[chunk_size];
+
+	for (size_t begin = 0; begin < count; begin += chunk_size) {
+		size_t size = count - begin < chunk_size ? count - begin : chunk_size;
+		projection.grid_to_geodetic(grid + begin, lat_lon, size);
+
+		for (size_t i = 0; i < size; ++i) {
+			quadkeys[begin + i] = quadkey(geodetic_to_tile(lat_lon[i].x, lat_lon[i].y, zoom));
+		}
+	}
+}
+
+uint64_t WebMercator::quadkey(const TileKey& tile)
+{
+	// Interleave the bits of the row and column, row bit first.
+	uint64_t key = 0;
+
+	for (uint32_t level = clampZoom(tile.zoom); level > 0; --level) {
+		uint32_t mask = 1u << (level - 1);
+		key <<= 2;
+		key |= (tile.x & mask) ? 1 : 0;
+		key |= (tile.y & mask) ? 2 : 0;
+	}
+
+	return key;
+}
+
+std::string WebMercator::quadkey_string(const TileKey& tile)
+{
+	uint32_t zoom = clampZoom(tile.zoom);
+	std::string key(zoom, '0');
+	uint64_t value = quadkey(tile);
+
+	for (uint32_t i = zoom; i > 0; --i) {
+		key[i - 1] = static_cast<char>('0' + (value & 3));
+		value >>= 2;
+	}
+
+	return key;
+}
+
+WebMercator::TileKey WebMercator::quadkey_to_tile(uint64_t quadkey, uint32_t zoom)
+{
+	TileKey tile;
+	zoom = clampZoom(zoom);
+	tile.zoom = zoom;
+
+	for (uint32_t level = 0; level < zoom; ++level) {
+		uint64_t digit = (quadkey >> (2 * level)) & 3;
+		tile.x |= static_cast<uint32_t>(digit & 1) << level;
+		tile.y |= static_cast<uint32_t>((digit >> 1) & 1) << level;
+	}
+
+	return tile;
+}
+
+} // namespace vti
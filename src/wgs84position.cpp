@@ -10,6 +10,9 @@
 
 #include <iostream>
 #include <iomanip>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
 #include <limits> // std::numeric_limits
 #include <algorithm> // std::replace
 #include <iterator>
@@ -18,6 +21,159 @@
 
 namespace vti {
 
+namespace {
+
+// Helpers for the allocation free parsers. All ranges are [begin, end).
+
+bool isWhitespace(char c)
+{
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+void trimRange(const char*& begin, const char*& end)
+{
+	while (begin < end && isWhitespace(*begin)) {
+		++begin;
+	}
+
+	while (end > begin && isWhitespace(*(end - 1))) {
+		--end;
+	}
+}
+
+const char* findChar(const char* begin, const char* end, char c)
+{
+	while (begin < end && *begin != c) {
+		++begin;
+	}
+
+	return begin;
+}
+
+// The degree sign used by the string conversions is 0xBA, but also accept
+// the Latin-1 degree sign 0xB0. The lead byte of the UTF-8 encoded variants
+// is ignored when the number is parsed.
+const char* findDegreeSign(const char* begin, const char* end)
+{
+	while (begin < end && *begin != '\xBA' && *begin != '\xB0') {
+		++begin;
+	}
+
+	return begin;
+}
+
+// Parse a decimal number, accepting both comma and dot as decimal separator.
+// With signed false, a leading sign is rejected.
+bool parseNumber(const char* begin, const char* end, double& value, bool isSigned = true)
+{
+	char buffer[64];
+	trimRange(begin, end);
+	size_t length = static_cast<size_t>(end - begin);
+
+	if (length == 0 || length >= sizeof(buffer) || (!isSigned && (*begin == '-' || *begin == '+'))) {
+		return false;
+	}
+
+	for (size_t i = 0; i < length; ++i) {
+		char c = begin[i] == ',' ? '.' : begin[i];
+
+		// Plain decimal numbers only, strtod also takes hex, inf and nan.
+		if ((c < '0' || c > '9') && c != '.' && c != '-' && c != '+' && c != 'e' && c != 'E') {
+			return false;
+		}
+
+		buffer[i] = c;
+	}
+
+	buffer[length] = '\0';
+	char* parsed = buffer;
+	value = strtod(buffer, &parsed);
+	// The whole range must be the number.
+	return parsed == buffer + length;
+}
+
+// Parse a value such as "N 59\xBA 20' 56.09287\"". The value must start with
+// the hemisphere letter, or '-', and end with the last sign. The fields are
+// unsigned, the degrees integral and the minutes and seconds below 60.
+bool parseAngle(const char* begin, const char* end, bool withSeconds, char positiveChar, char negativeChar, double limit, double& result)
+{
+	trimRange(begin, end);
+
+	if (begin == end) {
+		return false;
+	}
+
+	char direction = *begin++;
+
+	if (direction != positiveChar && direction != negativeChar && direction != '-') {
+		return false;
+	}
+
+	const char* degreeEnd = findDegreeSign(begin, end);
+	const char* minuteEnd = findChar(degreeEnd, end, '\'');
+	const char* lastSign = minuteEnd;
+	double degrees = 0.0;
+	double minutes = 0.0;
+	double seconds = 0.0;
+
+	if (degreeEnd == end || minuteEnd == end) {
+		return false;
+	}
+
+	// Skip the lead byte of a UTF-8 encoded degree sign.
+	const char* degreeNumberEnd = degreeEnd > begin && *(degreeEnd - 1) == '\xC2' ? degreeEnd - 1 : degreeEnd;
+
+	if (!parseNumber(begin, degreeNumberEnd, degrees, false) || degrees != floor(degrees) ||
+		!parseNumber(degreeEnd + 1, minuteEnd, minutes, false) || minutes >= 60.0) {
+		return false;
+	}
+
+	if (withSeconds) {
+		const char* secondEnd = findChar(minuteEnd + 1, end, '"');
+
+		if (secondEnd == end || !parseNumber(minuteEnd + 1, secondEnd, seconds, false) || seconds >= 60.0) {
+			return false;
+		}
+
+		lastSign = secondEnd;
+	}
+
+	if (lastSign + 1 != end) {
+		return false;
+	}
+
+	double value = degrees + minutes / 60.0 + seconds / 3600.0;
+
+	if (direction == negativeChar || direction == '-') {
+		value *= -1;
+	}
+
+	if (fabs(value) > limit) {
+		return false;
+	}
+
+	result = value;
+	return true;
+}
+
+bool parseValue(const char* begin, const char* end, WGS84Position::WGS84Format format, char positiveChar, char negativeChar, double limit, double& result)
+{
+	if (format == WGS84Position::WGS84Format::Degrees) {
+		double value = 0.0;
+
+		if (!parseNumber(begin, end, value) || fabs(value) > limit) {
+			return false;
+		}
+
+		result = value;
+		return true;
+	}
+
+	return parseAngle(begin, end, format == WGS84Position::WGS84Format::DegreesMinutesSeconds, positiveChar, negativeChar, limit, result);
+}
+
+} // namespace
+
 WGS84Position::WGS84Position(const std::string& positionString, WGS84Format format) : Position(Grid::WGS84)
 {
 	if (format == WGS84Format::Degrees) {
@@ -225,4 +381,70 @@ double WGS84Position::parseValueFromDmsString(std::string value, const std::stri
 	return retVal;
 }
 
+bool WGS84Position::parse(const char* positionString, WGS84Format format, WGS84Position& position) noexcept
+{
+	if (positionString == nullptr) {
+		return false;
+	}
+
+	const char* begin = positionString;
+	const char* end = positionString + strlen(positionString);
+	const char* latBegin = begin;
+	const char* latEnd = end;
+	const char* lonBegin = end;
+	trimRange(begin, end);
+
+	if (format == WGS84Format::Degrees) {
+		// Two whitespace separated values.
+		latBegin = begin;
+		latEnd = latBegin;
+
+		while (latEnd < end && !isWhitespace(*latEnd)) {
+			++latEnd;
+		}
+
+		lonBegin = latEnd;
+
+		while (lonBegin < end && isWhitespace(*lonBegin)) {
+			++lonBegin;
+		}
+
+		if (lonBegin == end || findChar(lonBegin, end, ' ') != end || findChar(lonBegin, end, '\t') != end) {
+			return false;
+		}
+	} else {
+		// Latitude ends with the first minute or second sign.
+		char separator = format == WGS84Format::DegreesMinutes ? '\'' : '"';
+		latEnd = findChar(begin, end, separator);
+
+		if (latEnd == end) {
+			return false;
+		}
+
+		++latEnd;
+		lonBegin = latEnd;
+	}
+
+	double latitude = 0.0;
+	double longitude = 0.0;
+
+	if (!parseValue(latBegin, latEnd, format, 'N', 'S', 90.0, latitude) || !parseValue(lonBegin, end, format, 'E', 'W', 180.0, longitude)) {
+		return false;
+	}
+
+	position.m_latitude = latitude;
+	position.m_longitude = longitude;
+	return true;
+}
+
+bool WGS84Position::parseLatitude(const char* value, WGS84Format format, double& latitude) noexcept
+{
+	return value != nullptr && parseValue(value, value + strlen(value), format, 'N', 'S', 90.0, latitude);
+}
+
+bool WGS84Position::parseLongitude(const char* value, WGS84Format format, double& longitude) noexcept
+{
+	return value != nullptr && parseValue(value, value + strlen(value), format, 'E', 'W', 180.0, longitude);
+}
+
 } // namespace vti
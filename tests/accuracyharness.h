@@ -0,0 +1,297 @@
+/*
+ * accuracyharness.h
+ *
+ *  Created on: October 19, 2026
+ *      Author: Bjorn Blissing
+ */
+
+#ifndef _COORDINATE_ACCURACYHARNESS_H_
+#define _COORDINATE_ACCURACYHARNESS_H_ 1
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "gausskreuger.h"
+
+namespace vti {
+
+	// The Kruger series of GaussKreuger evaluated in long double and without
+	// millimetre rounding. Used as the reference for faster conversion paths.
+	class ReferenceKreuger : public GaussKreuger {
+	public:
+		typedef long double Real;
+
+		static Real pi() { return 3.14159265358979323846264338327950288L; }
+
+		void geodetic_to_grid(Real latitude, Real longitude, Real& x, Real& y) const
+		{
+			Real f = m_flattening;
+			Real e2 = f * (2.0L - f);
+			Real n = f / (2.0L - f);
+			Real a_roof = m_axis / (1.0L + n) * (1.0L + n * n / 4.0L + n * n * n * n / 64.0L);
+			Real A = e2;
+			Real B = (5.0L * e2 * e2 - e2 * e2 * e2) / 6.0L;
+			Real C = (104.0L * e2 * e2 * e2 - 45.0L * e2 * e2 * e2 * e2) / 120.0L;
+			Real D = (1237.0L * e2 * e2 * e2 * e2) / 1260.0L;
+			Real beta[4] = {
+				n / 2.0L - 2.0L * n * n / 3.0L + 5.0L * n * n * n / 16.0L + 41.0L * n * n * n * n / 180.0L,
+				13.0L * n * n / 48.0L - 3.0L * n * n * n / 5.0L + 557.0L * n * n * n * n / 1440.0L,
+				61.0L * n * n * n / 240.0L - 103.0L * n * n * n * n / 140.0L,
+				49561.0L * n * n * n * n / 161280.0L
+			};
+			Real deg_to_rad = pi() / 180.0L;
+			Real phi = latitude * deg_to_rad;
+			Real s = std::sin(phi);
+			Real phi_star = phi - s * std::cos(phi) * (A + B * s * s + C * s * s * s * s + D * s * s * s * s * s * s);
+			Real delta_lambda = (longitude - static_cast<Real>(m_central_meridian)) * deg_to_rad;
+			Real xi_prim = std::atan(std::tan(phi_star) / std::cos(delta_lambda));
+			Real eta_prim = std::atanh(std::cos(phi_star) * std::sin(delta_lambda));
+			Real xi = xi_prim;
+			Real eta = eta_prim;
+
+			for (int k = 0; k < 4; ++k) {
+				Real m = 2.0L * (k + 1);
+				xi += beta[k] * std::sin(m * xi_prim) * std::cosh(m * eta_prim);
+				eta += beta[k] * std::cos(m * xi_prim) * std::sinh(m * eta_prim);
+			}
+
+			x = m_scale * a_roof * xi + m_false_northing;
+			y = m_scale * a_roof * eta + m_false_easting;
+		}
+
+		void grid_to_geodetic(Real x, Real y, Real& latitude, Real& longitude) const
+		{
+			Real f = m_flattening;
+			Real e2 = f * (2.0L - f);
+			Real n = f / (2.0L - f);
+			Real a_roof = m_axis / (1.0L + n) * (1.0L + n * n / 4.0L + n * n * n * n / 64.0L);
+			Real delta[4] = {
+				n / 2.0L - 2.0L * n * n / 3.0L + 37.0L * n * n * n / 96.0L - n * n * n * n / 360.0L,
+				n * n / 48.0L + n * n * n / 15.0L - 437.0L * n * n * n * n / 1440.0L,
+				17.0L * n * n * n / 480.0L - 37.0L * n * n * n * n / 840.0L,
+				4397.0L * n * n * n * n / 161280.0L
+			};
+			Real Astar = e2 + e2 * e2 + e2 * e2 * e2 + e2 * e2 * e2 * e2;
+			Real Bstar = -(7.0L * e2 * e2 + 17.0L * e2 * e2 * e2 + 30.0L * e2 * e2 * e2 * e2) / 6.0L;
+			Real Cstar = (224.0L * e2 * e2 * e2 + 889.0L * e2 * e2 * e2 * e2) / 120.0L;
+			Real Dstar = -(4279.0L * e2 * e2 * e2 * e2) / 1260.0L;
+			Real xi = (x - m_false_northing) / (m_scale * a_roof);
+			Real eta = (y - m_false_easting) / (m_scale * a_roof);
+			Real xi_prim = xi;
+			Real eta_prim = eta;
+
+			for (int k = 0; k < 4; ++k) {
+				Real m = 2.0L * (k + 1);
+				xi_prim -= delta[k] * std::sin(m * xi) * std::cosh(m * eta);
+				eta_prim -= delta[k] * std::cos(m * xi) * std::sinh(m * eta);
+			}
+
+			Real phi_star = std::asin(std::sin(xi_prim) / std::cosh(eta_prim));
+			Real delta_lambda = std::atan(std::sinh(eta_prim) / std::cos(xi_prim));
+			Real s = std::sin(phi_star);
+			Real phi = phi_star + s * std::cos(phi_star) * (Astar + Bstar * s * s + Cstar * s * s * s * s + Dstar * s * s * s * s * s * s);
+			latitude = phi * 180.0L / pi();
+			longitude = m_central_meridian + delta_lambda * 180.0L / pi();
+		}
+
+		// Metres per degree of latitude and of longitude at the given latitude.
+		void metres_per_degree(Real latitude, Real& north, Real& east) const
+		{
+			Real e2 = m_flattening * (2.0L - m_flattening);
+			Real phi = latitude * pi() / 180.0L;
+			Real w = 1.0L - e2 * std::sin(phi) * std::sin(phi);
+			north = m_axis * (1.0L - e2) / (w * std::sqrt(w)) * pi() / 180.0L;
+			east = m_axis / std::sqrt(w) * std::cos(phi) * pi() / 180.0L;
+		}
+	};
+
+	// Evaluates conversion paths against ReferenceKreuger on dense grids over
+	// the area of use of every RT90 (GRS 80 and Bessel) and SWEREF 99 projection.
+	class AccuracyHarness {
+	public:
+		// A batch conversion path, e.g. GaussKreuger::geodetic_to_grid.
+		typedef std::function<void(const GaussKreuger&, const GaussKreuger::Coordinate*, GaussKreuger::Coordinate*, size_t)> Path;
+
+		struct Report {
+			std::string projection;
+			size_t points;
+			size_t rejected; // Points the path returned NaN for.
+			double forward_max_mm; // Grid error against the reference.
+			double forward_rms_mm;
+			double inverse_max_mm; // Geodetic error against the reference, as distance.
+			double inverse_rms_mm;
+			double round_trip_max_mm; // Distance between input and inverse(forward(input)).
+			double points_per_second; // Forward plus inverse.
+		};
+
+		explicit AccuracyHarness(double spacing = 0.05) : m_spacing(spacing) {}
+
+		static const std::vector<std::string>& projections()
+		{
+			static const char* names[] = {
+				"rt90_7.5_gon_v", "rt90_5.0_gon_v", "rt90_2.5_gon_v", "rt90_0.0_gon_v", "rt90_2.5_gon_o", "rt90_5.0_gon_o",
+				"bessel_rt90_7.5_gon_v", "bessel_rt90_5.0_gon_v", "bessel_rt90_2.5_gon_v",
+				"bessel_rt90_0.0_gon_v", "bessel_rt90_2.5_gon_o", "bessel_rt90_5.0_gon_o",
+				"sweref_99_tm", "sweref_99_1200", "sweref_99_1330", "sweref_99_1500", "sweref_99_1630",
+				"sweref_99_1800", "sweref_99_1415", "sweref_99_1545", "sweref_99_1715", "sweref_99_1845",
+				"sweref_99_2015", "sweref_99_2145", "sweref_99_2315"
+			};
+			static const std::vector<std::string> list(names, names + sizeof(names) / sizeof(names[0]));
+			return list;
+		}
+
+		// Evaluate one path pair over all projections.
+		std::vector<Report> evaluate(const Path& forward, const Path& inverse)
+		{
+			std::vector<Report> reports;
+
+			for (size_t i = 0; i < projections().size(); ++i) {
+				reports.push_back(evaluate(projections()[i], forward, inverse));
+			}
+
+			return reports;
+		}
+
+		Report evaluate(const std::string& name, const Path& forward, const Path& inverse)
+		{
+			const Dataset& data = dataset(name);
+			const size_t count = data.geodetic.size();
+			std::vector<GaussKreuger::Coordinate> grid(count);
+			std::vector<GaussKreuger::Coordinate> back(count);
+			std::vector<GaussKreuger::Coordinate> roundTrip(count);
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			forward(data.reference, &data.geodetic[0], &grid[0], count);
+			inverse(data.reference, &data.grid[0], &back[0], count);
+			double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			inverse(data.reference, &grid[0], &roundTrip[0], count);
+
+			Report report;
+			report.projection = name;
+			report.points = count;
+			report.rejected = 0;
+			report.forward_max_mm = report.forward_rms_mm = 0.0;
+			report.inverse_max_mm = report.inverse_rms_mm = 0.0;
+			report.round_trip_max_mm = 0.0;
+			report.points_per_second = 2.0 * count / seconds;
+			Real forwardSum = 0.0L;
+			Real inverseSum = 0.0L;
+
+			for (size_t i = 0; i < count; ++i) {
+				// Paths may reject points by returning NaN.
+				if (std::isnan(grid[i].x) || std::isnan(back[i].x) || std::isnan(roundTrip[i].x)) {
+					++report.rejected;
+					continue;
+				}
+
+				Real dx = grid[i].x - data.x[i];
+				Real dy = grid[i].y - data.y[i];
+				Real forwardError = 1000.0L * std::sqrt(dx * dx + dy * dy);
+				Real inverseError = distance(data.reference, back[i].x, back[i].y, data.latitude[i], data.longitude[i]);
+				Real roundTripError = distance(data.reference, roundTrip[i].x, roundTrip[i].y, data.geodetic[i].x, data.geodetic[i].y);
+				forwardSum += forwardError * forwardError;
+				inverseSum += inverseError * inverseError;
+				report.forward_max_mm = std::max(report.forward_max_mm, static_cast<double>(forwardError));
+				report.inverse_max_mm = std::max(report.inverse_max_mm, static_cast<double>(inverseError));
+				report.round_trip_max_mm = std::max(report.round_trip_max_mm, static_cast<double>(roundTripError));
+			}
+
+			size_t accepted = count - report.rejected;
+			report.forward_rms_mm = accepted ? static_cast<double>(std::sqrt(forwardSum / accepted)) : 0.0;
+			report.inverse_rms_mm = accepted ? static_cast<double>(std::sqrt(inverseSum / accepted)) : 0.0;
+			return report;
+		}
+
+		static void print(const char* path, const std::vector<Report>& reports)
+		{
+			std::cout << path << std::endl;
+			std::cout << std::setw(24) << std::left << "projection" << std::right << std::setw(8) << "points" << std::setw(9) << "rejected"
+					  << std::setw(12) << "fwd max" << std::setw(12) << "fwd rms" << std::setw(12) << "inv max"
+					  << std::setw(12) << "inv rms" << std::setw(12) << "trip max" << std::setw(12) << "Mpts/s" << std::endl;
+
+			for (size_t i = 0; i < reports.size(); ++i) {
+				const Report& r = reports[i];
+				std::cout << std::setw(24) << std::left << r.projection << std::right << std::setw(8) << r.points << std::setw(9) << r.rejected << std::fixed
+						  << std::setprecision(4) << std::setw(12) << r.forward_max_mm << std::setw(12) << r.forward_rms_mm
+						  << std::setw(12) << r.inverse_max_mm << std::setw(12) << r.inverse_rms_mm << std::setw(12) << r.round_trip_max_mm
+						  << std::setprecision(2) << std::setw(12) << r.points_per_second / 1e6 << std::endl;
+				std::cout.unsetf(std::ios::floatfield);
+			}
+		}
+	protected:
+		typedef ReferenceKreuger::Real Real;
+
+		// Sample points and reference results, computed once per projection.
+		struct Dataset {
+			ReferenceKreuger reference;
+			std::vector<GaussKreuger::Coordinate> geodetic;
+			std::vector<Real> x; // Reference grid coordinates.
+			std::vector<Real> y;
+			std::vector<GaussKreuger::Coordinate> grid; // Reference grid coordinates rounded to double.
+			std::vector<Real> latitude; // Reference inverse of the rounded grid coordinates.
+			std::vector<Real> longitude;
+		};
+
+		const Dataset& dataset(const std::string& name)
+		{
+			std::map<std::string, Dataset>::iterator found = m_datasets.find(name);
+
+			if (found != m_datasets.end()) {
+				return found->second;
+			}
+
+			Dataset& data = m_datasets[name];
+			data.reference.swedish_params(name);
+			const GaussKreuger::Bounds& area = data.reference.geodetic_bounds();
+
+			for (double lat = area.min_x; lat <= area.max_x; lat += m_spacing) {
+				for (double lon = area.min_y; lon <= area.max_y; lon += m_spacing) {
+					GaussKreuger::Coordinate point;
+					point.x = lat;
+					point.y = lon;
+					data.geodetic.push_back(point);
+				}
+			}
+
+			const size_t count = data.geodetic.size();
+			data.x.resize(count);
+			data.y.resize(count);
+			data.grid.resize(count);
+			data.latitude.resize(count);
+			data.longitude.resize(count);
+
+			for (size_t i = 0; i < count; ++i) {
+				data.reference.geodetic_to_grid(data.geodetic[i].x, data.geodetic[i].y, data.x[i], data.y[i]);
+				data.grid[i].x = static_cast<double>(data.x[i]);
+				data.grid[i].y = static_cast<double>(data.y[i]);
+				data.reference.grid_to_geodetic(data.grid[i].x, data.grid[i].y, data.latitude[i], data.longitude[i]);
+			}
+
+			return data;
+		}
+
+		// Millimetres between two geodetic coordinates, in the local tangent plane.
+		static ReferenceKreuger::Real distance(const ReferenceKreuger& reference, ReferenceKreuger::Real latitude1, ReferenceKreuger::Real longitude1,
+											   ReferenceKreuger::Real latitude2, ReferenceKreuger::Real longitude2)
+		{
+			ReferenceKreuger::Real north;
+			ReferenceKreuger::Real east;
+			reference.metres_per_degree(latitude2, north, east);
+			ReferenceKreuger::Real dn = (latitude1 - latitude2) * north;
+			ReferenceKreuger::Real de = (longitude1 - longitude2) * east;
+			return 1000.0L * std::sqrt(dn * dn + de * de);
+		}
+
+		double m_spacing; // Degrees between grid points.
+		std::map<std::string, Dataset> m_datasets;
+	};
+
+} // namespace vti
+
+#endif // _COORDINATE_ACCURACYHARNESS_H_
@@ -0,0 +1,354 @@
+/*
+ * benchmarks.cpp
+ *
+ *  Created on: October 19, 2026
+ *      Author: Bjorn Blissing
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "rt90position.h"
+#include "sweref99position.h"
+#include "datasetgenerator.h"
+#include "accuracyharness.h"
+
+using namespace vti;
+
+typedef std::chrono::steady_clock Clock;
+
+// Time a single call repeatedly and report the latency distribution.
+template <typename Function>
+void reportLatency(const char* name, size_t iterations, Function function)
+{
+	std::vector<double> samples(iterations);
+
+	for (size_t i = 0; i < iterations; ++i) {
+		Clock::time_point start = Clock::now();
+		function(i);
+		Clock::time_point stop = Clock::now();
+		samples[i] = std::chrono::duration<double, std::nano>(stop - start).count();
+	}
+
+	std::sort(samples.begin(), samples.end());
+	double sum = 0.0;
+
+	for (size_t i = 0; i < iterations; ++i) {
+		sum += samples[i];
+	}
+
+	std::cout << name << ": mean " << sum / iterations << " ns, p99 " << samples[iterations * 99 / 100]
+			  << " ns, p99.9 " << samples[iterations * 999 / 1000] << " ns, max " << samples.back() << " ns" << std::endl;
+}
+
+int benchmarkRealTimeLatency()
+{
+	const size_t iterations = 100000;
+	WGS84Position position;
+	volatile double sink = 0.0;
+	reportLatency("WGS84Position::parse (DMS)", iterations, [&](size_t) {
+		WGS84Position::parse("N 59\xBA 58' 55.23\" E 017\xBA 50' 06.12\"", WGS84Position::WGS84Format::DegreesMinutesSeconds, position);
+	});
+	reportLatency("WGS84 -> RT90 2.5 gon V", iterations, [&](size_t i) {
+		RT90Position rt90(WGS84Position(59.0 + i * 1e-6, 17.8), RT90Position::RT90Projection::rt90_2_5_gon_v);
+		sink = rt90.getLatitude();
+	});
+	reportLatency("RT90 2.5 gon V -> WGS84", iterations, [&](size_t i) {
+		RT90Position rt90(6583052.0 + i * 0.01, 1627548.0);
+		sink = rt90.toWGS84().getLatitude();
+	});
+	reportLatency("WGS84 -> SWEREF 99 TM", iterations, [&](size_t i) {
+		SWEREF99Position sweref(WGS84Position(59.0 + i * 1e-6, 17.8), SWEREF99Position::SWEREFProjection::sweref_99_tm);
+		sink = sweref.getLatitude();
+	});
+	reportLatency("SWEREF 99 TM -> WGS84", iterations, [&](size_t i) {
+		SWEREF99Position sweref(6652797.165 + i * 0.01, 658185.201);
+		sink = sweref.toWGS84().getLatitude();
+	});
+	(void)sink;
+	return 0;
+}
+
+// Throughput baselines, set from the command line.
+static std::string baselinePath;
+static double baselineMargin = 0.5;
+static bool recordBaseline = false;
+
+// Baseline file: one "name points_per_second" pair per line, # starts a comment.
+std::map<std::string, double> readBaseline()
+{
+	std::map<std::string, double> baseline;
+	std::ifstream file(baselinePath.c_str());
+	std::string line;
+
+	while (std::getline(file, line)) {
+		std::istringstream fields(line);
+		std::string name;
+		double rate;
+
+		if (line.empty() || line[0] == '#' || !(fields >> name >> rate)) {
+			continue;
+		}
+
+		baseline[name] = rate;
+	}
+
+	return baseline;
+}
+
+bool writeBaseline(const std::map<std::string, double>& baseline)
+{
+	std::ofstream file(baselinePath.c_str());
+	file << "# Throughput baseline in points per second, see tests/benchmarks.cpp" << std::endl;
+
+	for (std::map<std::string, double>::const_iterator it = baseline.begin(); it != baseline.end(); ++it) {
+		file << it->first << " " << static_cast<long long>(it->second) << std::endl;
+	}
+
+	return static_cast<bool>(file);
+}
+
+// Run a workload over count points a few times and compare the best
+// throughput against the baseline. Fails if it is more than the margin below.
+template <typename Function>
+int checkThroughput(const char* name, size_t count, Function function)
+{
+	double best = 0.0;
+
+	for (int run = 0; run < 3; ++run) {
+		Clock::time_point start = Clock::now();
+		function();
+		double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+		best = std::max(best, count / seconds);
+	}
+
+	std::cout << name << ": " << best / 1e6 << " M points/s" << std::endl;
+
+	if (baselinePath.empty()) {
+		return 0;
+	}
+
+	std::map<std::string, double> baseline = readBaseline();
+
+	if (recordBaseline) {
+		baseline[name] = best;
+		return writeBaseline(baseline) ? 0 : -1;
+	}
+
+	if (baseline.find(name) == baseline.end()) {
+		std::cout << "No baseline recorded for " << name << std::endl;
+		return 0;
+	}
+
+	double limit = baseline[name] * (1.0 - baselineMargin);
+	std::cout << "Baseline " << baseline[name] / 1e6 << " M points/s, limit " << limit / 1e6 << " M points/s" << std::endl;
+
+	if (best < limit) {
+		std::cerr << name << " throughput regression." << std::endl;
+		return -1;
+	}
+
+	return 0;
+}
+
+int benchmarkUniformSweden()
+{
+	DatasetGenerator generator;
+	std::vector<GaussKreuger::Coordinate> points = generator.uniformSweden(2000000);
+	volatile double sink = 0.0;
+	return checkThroughput("UniformSweden", points.size(), [&]() {
+		for (size_t i = 0; i < points.size(); ++i) {
+			SWEREF99Position sweref(WGS84Position(points[i].x, points[i].y), SWEREF99Position::SWEREFProjection::sweref_99_tm);
+			sink = sweref.toWGS84().getLatitude();
+		}
+	});
+}
+
+int benchmarkTrajectories()
+{
+	DatasetGenerator generator;
+	std::vector<GaussKreuger::Coordinate> points = generator.trajectories(2000000);
+	std::vector<GaussKreuger::Coordinate> grid(points.size());
+	GaussKreuger sweref;
+	sweref.swedish_params("sweref_99_tm");
+	return checkThroughput("Trajectories", points.size(), [&]() {
+		sweref.geodetic_to_grid(&points[0], &grid[0], points.size());
+		sweref.grid_to_geodetic(&grid[0], &grid[0], grid.size());
+	});
+}
+
+int benchmarkMixedRT90()
+{
+	DatasetGenerator generator;
+	std::vector<DatasetGenerator::RT90Point> points = generator.mixedRT90(2000000);
+	volatile double sink = 0.0;
+	return checkThroughput("MixedRT90", points.size(), [&]() {
+		for (size_t i = 0; i < points.size(); ++i) {
+			RT90Position rt90(points[i].grid.x, points[i].grid.y, points[i].projection);
+			sink = rt90.toWGS84().getLatitude();
+		}
+	});
+}
+
+int benchmarkDmsCorpus()
+{
+	DatasetGenerator generator;
+	std::vector<std::string> corpus = generator.dmsCorpus(1000000);
+	WGS84Position position;
+	size_t parsed = 0;
+	int result = checkThroughput("DmsCorpus", corpus.size(), [&]() {
+		parsed = 0;
+
+		for (size_t i = 0; i < corpus.size(); ++i) {
+			parsed += WGS84Position::parse(corpus[i].c_str(), WGS84Position::WGS84Format::DegreesMinutesSeconds, position) ? 1 : 0;
+		}
+	});
+
+	if (parsed != corpus.size()) {
+		std::cerr << "Only " << parsed << " of " << corpus.size() << " DMS strings parsed." << std::endl;
+		return -1;
+	}
+
+	return result;
+}
+
+int benchmarkMalformedCorpus()
+{
+	DatasetGenerator generator;
+	std::vector<std::string> corpus = generator.malformedCorpus(1000000);
+	WGS84Position position;
+	size_t parsed = 0;
+	int result = checkThroughput("MalformedCorpus", corpus.size(), [&]() {
+		parsed = 0;
+
+		for (size_t i = 0; i < corpus.size(); ++i) {
+			parsed += WGS84Position::parse(corpus[i].c_str(), WGS84Position::WGS84Format::DegreesMinutesSeconds, position) ? 1 : 0;
+		}
+	});
+
+	// Every entry is broken and must be rejected.
+	if (parsed != 0) {
+		std::cerr << parsed << " of " << corpus.size() << " malformed strings were accepted." << std::endl;
+		return -1;
+	}
+
+	return result;
+}
+
+// Fail if any projection exceeds the limits, in millimetres. The kernel
+// rounds grid coordinates to millimetres, which allows up to 0.71 mm.
+int checkAccuracy(const char* path, const std::vector<AccuracyHarness::Report>& reports)
+{
+	AccuracyHarness::print(path, reports);
+
+	for (size_t i = 0; i < reports.size(); ++i) {
+		const AccuracyHarness::Report& report = reports[i];
+
+		if (report.forward_max_mm > 1.0 || report.inverse_max_mm > 0.01 || report.round_trip_max_mm > 1.0) {
+			std::cerr << path << " is not accurate enough for " << report.projection << std::endl;
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+int benchmarkAccuracy()
+{
+	AccuracyHarness harness;
+	int result = 0;
+	result |= checkAccuracy("Single point", harness.evaluate(
+	[](const GaussKreuger & projection, const GaussKreuger::Coordinate * in, GaussKreuger::Coordinate * out, size_t count) {
+		for (size_t i = 0; i < count; ++i) {
+			out[i] = projection.geodetic_to_grid(in[i].x, in[i].y);
+		}
+	},
+	[](const GaussKreuger & projection, const GaussKreuger::Coordinate * in, GaussKreuger::Coordinate * out, size_t count) {
+		for (size_t i = 0; i < count; ++i) {
+			out[i] = projection.grid_to_geodetic(in[i].x, in[i].y);
+		}
+	}));
+	result |= checkAccuracy("Batch", harness.evaluate(
+	[](const GaussKreuger & projection, const GaussKreuger::Coordinate * in, GaussKreuger::Coordinate * out, size_t count) {
+		projection.geodetic_to_grid(in, out, count);
+	},
+	[](const GaussKreuger & projection, const GaussKreuger::Coordinate * in, GaussKreuger::Coordinate * out, size_t count) {
+		projection.grid_to_geodetic(in, out, count);
+	}));
+	std::vector<unsigned char> valid;
+	result |= checkAccuracy("Masked batch", harness.evaluate(
+	[&](const GaussKreuger & projection, const GaussKreuger::Coordinate * in, GaussKreuger::Coordinate * out, size_t count) {
+		valid.resize(count);
+		projection.geodetic_to_grid(in, out, &valid[0], count);
+	},
+	[&](const GaussKreuger & projection, const GaussKreuger::Coordinate * in, GaussKreuger::Coordinate * out, size_t count) {
+		valid.resize(count);
+		projection.grid_to_geodetic(in, out, &valid[0], count);
+	}));
+	return result;
+}
+
+// Usage: benchmarks <number> [baseline file] [margin | record]
+int main(int argc, char* argv[])
+{
+	if (argc < 2 || argc > 4) {
+		std::cerr << "Unknown benchmark number" << std::endl;
+		return -1;
+	}
+
+	if (argc > 2) {
+		baselinePath = argv[2];
+	}
+
+	if (argc > 3) {
+		recordBaseline = std::string(argv[3]) == "record";
+		baselineMargin = recordBaseline ? 0.0 : atof(argv[3]);
+	}
+
+	int retVal = -1;
+	// Get benchmark number
+	int benchmarkNumber = atoi(argv[1]);
+
+	switch (benchmarkNumber) {
+		case 1:
+			retVal = benchmarkRealTimeLatency();
+			break;
+
+		case 2:
+			retVal = benchmarkUniformSweden();
+			break;
+
+		case 3:
+			retVal = benchmarkTrajectories();
+			break;
+
+		case 4:
+			retVal = benchmarkMixedRT90();
+			break;
+
+		case 5:
+			retVal = benchmarkDmsCorpus();
+			break;
+
+		case 6:
+			retVal = benchmarkMalformedCorpus();
+			break;
+
+		case 7:
+			retVal = benchmarkAccuracy();
+			break;
+
+		default:
+			std::cerr << "Unknown benchmark" << std::endl;
+			break;
+	}
+
+	return retVal;
+}
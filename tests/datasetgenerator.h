@@ -0,0 +1,212 @@
+/*
+ * datasetgenerator.h
+ *
+ *  Created on: October 19, 2026
+ *      Author: Bjorn Blissing
+ */
+
+#ifndef _COORDINATE_DATASETGENERATOR_H_
+#define _COORDINATE_DATASETGENERATOR_H_ 1
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "gausskreuger.h"
+#include "rt90position.h"
+
+namespace vti {
+
+	// Deterministic synthetic workloads over Sweden for tests and benchmarks.
+	// Uses its own generator (SplitMix64) so the datasets are identical on
+	// every platform and standard library.
+	class DatasetGenerator {
+	public:
+		struct RT90Point {
+			RT90Position::RT90Projection projection;
+			GaussKreuger::Coordinate grid;
+		};
+
+		explicit DatasetGenerator(uint64_t seed = 20261019) : m_state(seed) {}
+
+		// Uniform in [0, 1).
+		double uniform()
+		{
+			return (next() >> 11) * (1.0 / 9007199254740992.0);
+		}
+
+		double uniform(double low, double high)
+		{
+			return low + (high - low) * uniform();
+		}
+
+		// Geodetic coordinates (latitude in x, longitude in y) uniform over the
+		// bounding box of Sweden.
+		std::vector<GaussKreuger::Coordinate> uniformSweden(size_t count)
+		{
+			std::vector<GaussKreuger::Coordinate> points(count);
+
+			for (size_t i = 0; i < count; ++i) {
+				points[i].x = uniform(55.4, 69.0);
+				points[i].y = uniform(11.2, 24.1);
+			}
+
+			return points;
+		}
+
+		// Vehicle tracks sampled once per second: random start, speed up to
+		// 30 m/s and a slowly drifting heading.
+		std::vector<GaussKreuger::Coordinate> trajectories(size_t count, size_t trackLength = 3600)
+		{
+			std::vector<GaussKreuger::Coordinate> points(count);
+			const double deg_to_rad = 3.14159265358979323846 / 180.0;
+			double heading = 0.0;
+			double speed = 0.0;
+
+			for (size_t i = 0; i < count; ++i) {
+				if (i % trackLength == 0) {
+					points[i].x = uniform(55.6, 68.5);
+					points[i].y = uniform(12.0, 23.0);
+					heading = uniform(0.0, 360.0);
+					speed = uniform(5.0, 30.0);
+					continue;
+				}
+
+				heading += uniform(-5.0, 5.0);
+				speed = std::min(30.0, std::max(0.0, speed + uniform(-1.0, 1.0)));
+				const GaussKreuger::Coordinate& previous = points[i - 1];
+				points[i].x = previous.x + speed * cos(heading * deg_to_rad) / 111320.0;
+				points[i].y = previous.y + speed * sin(heading * deg_to_rad) / (111320.0 * cos(previous.x * deg_to_rad));
+			}
+
+			return points;
+		}
+
+		// Grid coordinates spread over all six RT90 zones, each inside its own zone.
+		std::vector<RT90Point> mixedRT90(size_t count)
+		{
+			static const RT90Position::RT90Projection zones[6] = {
+				RT90Position::RT90Projection::rt90_7_5_gon_v, RT90Position::RT90Projection::rt90_5_0_gon_v,
+				RT90Position::RT90Projection::rt90_2_5_gon_v, RT90Position::RT90Projection::rt90_0_0_gon_v,
+				RT90Position::RT90Projection::rt90_2_5_gon_o, RT90Position::RT90Projection::rt90_5_0_gon_o
+			};
+			static const double meridians[6] = { 11.308, 13.558, 15.808, 18.058, 20.308, 22.558 };
+			GaussKreuger projections[6];
+
+			for (int zone = 0; zone < 6; ++zone) {
+				projections[zone].swedish_params(RT90Position::getProjectionName(zones[zone]));
+			}
+
+			std::vector<RT90Point> points(count);
+
+			for (size_t i = 0; i < count; ++i) {
+				int zone = static_cast<int>(next() % 6);
+				points[i].projection = zones[zone];
+				points[i].grid = projections[zone].geodetic_to_grid(uniform(55.4, 69.0), meridians[zone] + uniform(-1.2, 1.2));
+			}
+
+			return points;
+		}
+
+		// Positions as DMS text in the format accepted by WGS84Position::parse,
+		// with 0xBA as the degree sign like the rest of the library.
+		std::vector<std::string> dmsCorpus(size_t count)
+		{
+			std::vector<std::string> corpus(count);
+			std::vector<GaussKreuger::Coordinate> points = uniformSweden(count);
+
+			for (size_t i = 0; i < count; ++i) {
+				corpus[i] = dms('N', points[i].x, 2) + " " + dms('E', points[i].y, 3);
+			}
+
+			return corpus;
+		}
+
+		// DMS text where every entry is broken: truncated, garbled, out of
+		// range, empty, or with wrong hemisphere letters or trailing text.
+		std::vector<std::string> malformedCorpus(size_t count)
+		{
+			std::vector<std::string> corpus = dmsCorpus(count);
+
+			for (size_t i = 0; i < count; ++i) {
+				std::string& text = corpus[i];
+
+				switch (next() % 8) {
+					case 0:
+						// Always loses at least the closing second sign.
+						text = text.substr(0, static_cast<size_t>(next() % text.size()));
+						break;
+
+					case 1:
+						// No character of a valid string can be replaced by one of these.
+						text[static_cast<size_t>(next() % text.size())] = "x#?!"[next() % 4];
+						break;
+
+					case 2:
+					case 3: {
+						// Well formed, but out of range or signed fields.
+						static const char* const invalid[] = {
+							"N 95\xBA 00' 00.00\" E 017\xBA 50' 06.12\"",
+							"N 59\xBA 58' 55.23\" E 190\xBA 50' 06.12\"",
+							"S -95\xBA 00' 00.00\" E 017\xBA 50' 06.12\"",
+							"N 59\xBA 75' 00.00\" E 017\xBA 50' 06.12\"",
+							"N 59\xBA -30' 00.00\" E 017\xBA 50' 06.12\"",
+							"N 59\xBA 58' 60.00\" E 017\xBA 50' 06.12\"",
+							"N 59.5\xBA 58' 55.23\" E 017\xBA 50' 06.12\"",
+							"N 59\xBA 58' 55.23\" W -17\xBA 50' 06.12\""
+						};
+						text = invalid[next() % (sizeof(invalid) / sizeof(invalid[0]))];
+						break;
+					}
+
+					case 4:
+						text.clear();
+						break;
+
+					case 5:
+						text = "X " + text.substr(2);
+						break;
+
+					case 6:
+						text += " trailing garbage";
+						break;
+
+					default:
+						text = "E " + text.substr(2, text.find('E') - 2) + "N " + text.substr(text.find('E') + 2);
+						break;
+				}
+			}
+
+			return corpus;
+		}
+	protected:
+		uint64_t next()
+		{
+			uint64_t z = (m_state += 0x9e3779b97f4a7c15ULL);
+			z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+			z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+			return z ^ (z >> 31);
+		}
+
+		static std::string dms(char hemisphere, double value, int degreeDigits)
+		{
+			// Rounded to hundredths of a second first, so the seconds never
+			// print as 60.
+			long long hundredths = static_cast<long long>(value * 360000.0 + 0.5);
+			int degrees = static_cast<int>(hundredths / 360000);
+			int minutes = static_cast<int>(hundredths / 6000 % 60);
+			double seconds = static_cast<double>(hundredths % 6000) / 100.0;
+			char buffer[64];
+			snprintf(buffer, sizeof(buffer), "%c %0*d\xBA %02d' %05.2f\"", hemisphere, degreeDigits, degrees, minutes, seconds);
+			return buffer;
+		}
+
+		uint64_t m_state;
+	};
+
+} // namespace vti
+
+#endif // _COORDINATE_DATASETGENERATOR_H_
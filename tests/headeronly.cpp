@@ -0,0 +1,42 @@
+/*
+ * headeronly.cpp
+ *
+ *  Created on: October 19, 2026
+ *      Author: Bjorn Blissing
+ */
+
+// Built against the header-only kernels target only. Fails to link if any
+// kernel function is missing from the headers.
+
+#include <cmath>
+#include <iostream>
+
+#include "gausskreuger.h"
+
+using namespace vti;
+
+int main()
+{
+	GaussKreuger projection;
+
+	if (!projection.swedish_params("sweref_99_tm")) {
+		std::cerr << "Unknown projection" << std::endl;
+		return -1;
+	}
+
+	// Same point as in the SWEREF99 test.
+	GaussKreuger::Coordinate grid = projection.geodetic_to_grid(59.3406, 18.0569);
+	GaussKreuger::Coordinate geodetic = projection.grid_to_geodetic(grid.x, grid.y);
+	GaussKreuger::Coordinate batch[1];
+	batch[0].x = 59.3406;
+	batch[0].y = 18.0569;
+	projection.geodetic_to_grid(batch, batch, 1);
+
+	if (fabs(geodetic.x - 59.3406) > 1e-6 || fabs(geodetic.y - 18.0569) > 1e-6 ||
+		batch[0].x != grid.x || batch[0].y != grid.y) {
+		std::cerr << "Header-only kernels disagree: " << grid.x << ", " << grid.y << std::endl;
+		return -1;
+	}
+
+	return 0;
+}
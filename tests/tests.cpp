@@ -7,12 +7,85 @@
 
 #include <iostream>
 #include <cmath>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <string>
+#include <limits>
+#include <new>
 
 #include "rt90position.h"
 #include "sweref99position.h"
+#include "gausskreuger.h"
+#include "trajectorycodec.h"
+#include "localtangentplane.h"
+#include "lazyposition.h"
+#include "rasterreprojector.h"
+#include "envelopetransform.h"
+#include "webmercator.h"
+#include "geodesic.h"
+#include "spatialindex.h"
+#include "conversionbatcher.h"
+#include "arrowconversion.h"
+#include "helmert.h"
+#include "trajectorysimplifier.h"
+#include "incrementalconverter.h"
+#include "datasetgenerator.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include "conversionserver.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#define HAVE_CONVERSION_SERVER 1
+#endif
+
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.1415926535897932384626433832
+#endif
 
 using namespace vti;
 
+// Count heap allocations, used to verify the real-time safe parts of the API.
+static size_t allocationCount = 0;
+
+void* operator new(std::size_t size)
+{
+	++allocationCount;
+	void* memory = std::malloc(size ? size : 1);
+
+	if (!memory) {
+		throw std::bad_alloc();
+	}
+
+	return memory;
+}
+
+void* operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	std::free(memory);
+}
+
 bool compareWithEpsilon(double a, double b, double epsilon)
 {
 	return fabs(a - b) < epsilon;
@@ -163,37 +236,1820 @@ int testWGS84Parse()
 	return 0;
 }
 
-int main(int argc, char* argv[])
+int testTrajectoryCodec()
 {
-	if (argc != 2) {
-		std::cerr << "Unknown test number" << std::endl;
+	GaussKreuger projection;
+	projection.swedish_params("sweref_99_tm");
+	// A track heading north-east from Stockholm with roughly two metre steps.
+	std::vector<GaussKreuger::Coordinate> track;
+
+	for (int i = 0; i < 1000; ++i) {
+		double lat = 59.3489 + i * 0.000015 + 0.00001 * sin(i * 0.1);
+		double lon = 18.0473 + i * 0.000020;
+		track.push_back(projection.geodetic_to_grid(lat, lon));
+	}
+
+	TrajectoryCodec codec;
+	codec.encode(track, 100);
+
+	if (codec.block_count() != 10 || codec.size() != track.size()) {
+		std::cerr << "Unexpected block layout." << std::endl;
 		return -1;
 	}
 
-	int retVal = -1;
-	// Get test number
-	int testNumber = atoi(argv[1]);
+	if (codec.data().size() * 3 > track.size() * sizeof(GaussKreuger::Coordinate)) {
+		std::cerr << "Trajectory was not compressed." << std::endl;
+		return -1;
+	}
 
-	switch (testNumber) {
-		case 1:
-			retVal = testRT90ToWGS84();
-			break;
+	// Round trip through the serialized form.
+	TrajectoryCodec loaded;
 
-		case 2:
-			retVal = testWGS84ToRT90();
-			break;
+	if (!loaded.load(&codec.data()[0], codec.data().size())) {
+		std::cerr << "Could not load serialized trajectory." << std::endl;
+		return -1;
+	}
 
-		case 3:
-			retVal = testWGS84ToSweRef();
-			break;
+	std::vector<GaussKreuger::Coordinate> decoded = loaded.decode();
 
-		case 4:
-			retVal = testSweRefToWGS84();
-			break;
+	if (decoded.size() != track.size()) {
+		std::cerr << "Decoded trajectory has wrong length." << std::endl;
+		return -1;
+	}
 
-		case 5:
-			retVal = testWGS84Parse();
+	for (size_t i = 0; i < track.size(); ++i) {
+		if (decoded[i].x != track[i].x || decoded[i].y != track[i].y) {
+			std::cerr << "Decoded coordinate differs." << std::endl;
+			return -1;
+		}
+	}
+
+	// Random access to a block and conversion back to WGS84.
+	std::vector<GaussKreuger::Coordinate> block(loaded.block_size());
+
+	if (loaded.decode_block_to_geodetic(7, projection, &block[0]) != 100) {
+		std::cerr << "Could not decode block." << std::endl;
+		return -1;
+	}
+
+	GaussKreuger::Coordinate reference = projection.grid_to_geodetic(track[742].x, track[742].y);
+
+	if (!compareWithEpsilon(block[42].x, reference.x, 1e-12) || !compareWithEpsilon(block[42].y, reference.y, 1e-12)) {
+		std::cerr << "Decoded block does not match the single point conversion." << std::endl;
+		return -1;
+	}
+
+	// Truncated data must be rejected.
+	if (loaded.load(&codec.data()[0], codec.data().size() / 2)) {
+		std::cerr << "Truncated trajectory was accepted." << std::endl;
+		return -1;
+	}
+
+	// A huge count in a tiny header, and a block too short for its points.
+	// Varints: count = block size = 2^40, one block of length 2.
+	const unsigned char huge[] = { 0x80, 0x80, 0x80, 0x80, 0x80, 0x20, 0x80, 0x80, 0x80, 0x80, 0x80, 0x20, 0x02, 0x00, 0x00 };
+	// Count 3 in one block of length 4 holding only two points.
+	const unsigned char shortBlock[] = { 0x03, 0x03, 0x04, 0x02, 0x02, 0x02, 0x02 };
+	// Count 1 with a trailing byte in the block.
+	const unsigned char longBlock[] = { 0x01, 0x01, 0x03, 0x02, 0x02, 0x02 };
+
+	if (loaded.load(huge, sizeof(huge)) || loaded.load(shortBlock, sizeof(shortBlock)) || loaded.load(longBlock, sizeof(longBlock))) {
+		std::cerr << "Inconsistent trajectory header was accepted." << std::endl;
+		return -1;
+	}
+
+	// A large block size for a short trajectory is limited to its length.
+	const unsigned char wide[] = { 0x01, 0x80, 0x80, 0x80, 0x80, 0x80, 0x20, 0x02, 0x02, 0x04 };
+
+	if (!loaded.load(wide, sizeof(wide)) || loaded.block_size() != 1 || loaded.decode().size() != 1 || loaded.decode()[0].y != 0.002) {
+		std::cerr << "Wide block size was not limited." << std::endl;
+		return -1;
+	}
+
+	return 0;
+}
+
+int testRealTimeNoAllocation()
+{
+	WGS84Position dms;
+	WGS84Position dm;
+	WGS84Position degrees;
+	double rt90X = 0.0;
+	double rt90Y = 0.0;
+	double swerefX = 0.0;
+	double swerefY = 0.0;
+	double lat = 0.0;
+	double lon = 0.0;
+	bool parsed = true;
+	GaussKreuger::Coordinate batch[16];
+	size_t allocationsBefore = allocationCount;
+
+	for (int i = 0; i < 100; ++i) {
+		parsed &= WGS84Position::parse("N 59 58' 55.23\" E 017 50' 06.12\"", WGS84Position::WGS84Format::DegreesMinutesSeconds, dms);
+		parsed &= WGS84Position::parse("N 62 10,560' E 015 54.180'", WGS84Position::WGS84Format::DegreesMinutes, dm);
+		parsed &= WGS84Position::parse(" 59.3489\t18,0473 ", WGS84Position::WGS84Format::Degrees, degrees);
+		parsed &= WGS84Position::parseLatitude("S 33 52' 4.8\"", WGS84Position::WGS84Format::DegreesMinutesSeconds, lat);
+		parsed &= WGS84Position::parseLongitude("W 070 40,2'", WGS84Position::WGS84Format::DegreesMinutes, lon);
+		RT90Position rt90(dms, RT90Position::RT90Projection::rt90_2_5_gon_v);
+		SWEREF99Position sweref(dms, SWEREF99Position::SWEREFProjection::sweref_99_tm);
+		WGS84Position back = sweref.toWGS84();
+		back = rt90.toWGS84();
+		rt90X = rt90.getLatitude();
+		rt90Y = rt90.getLongitude();
+		swerefX = sweref.getLatitude();
+		swerefY = sweref.getLongitude();
+		GaussKreuger projection;
+		parsed &= projection.swedish_params(SWEREF99Position::getProjectionName(SWEREF99Position::SWEREFProjection::sweref_99_16_30));
+
+		for (int j = 0; j < 16; ++j) {
+			batch[j].x = 59.0 + j * 0.1;
+			batch[j].y = 16.5;
+		}
+
+		projection.geodetic_to_grid(batch, batch, 16);
+		projection.grid_to_geodetic(batch, batch, 16);
+	}
+
+	if (allocationCount != allocationsBefore) {
+		std::cerr << "Real-time API allocated memory." << std::endl;
+		return -1;
+	}
+
+	if (!parsed) {
+		std::cerr << "Real-time parsing failed." << std::endl;
+		return -1;
+	}
+
+	// Results must match the allocating API.
+	WGS84Position reference("N 59 58' 55.23\" E 017 50' 06.12\"", WGS84Position::WGS84Format::DegreesMinutesSeconds);
+
+	if (dms.getLatitude() != reference.getLatitude() || dms.getLongitude() != reference.getLongitude()) {
+		std::cerr << "Real-time DMS parsing differs." << std::endl;
+		return -1;
+	}
+
+	if (!compareWithEpsilon(rt90X, 6653174.343, 0.0001) || !compareWithEpsilon(rt90Y, 1613318.742, 0.0001) ||
+		!compareWithEpsilon(swerefX, 6652797.165, 0.0001) || !compareWithEpsilon(swerefY, 658185.201, 0.0001)) {
+		std::cerr << "Real-time conversion failed." << std::endl;
+		return -1;
+	}
+
+	if (!compareWithEpsilon(dm.getLatitude(), 62.176, 0.0001) || !compareWithEpsilon(dm.getLongitude(), 15.903, 0.0001) ||
+		!compareWithEpsilon(degrees.getLatitude(), 59.3489, 1e-12) || !compareWithEpsilon(degrees.getLongitude(), 18.0473, 1e-12) ||
+		!compareWithEpsilon(lat, -33.868, 0.0001) || !compareWithEpsilon(lon, -70.67, 0.0001)) {
+		std::cerr << "Real-time parsing gave wrong values." << std::endl;
+		return -1;
+	}
+
+	// The UTF-8 encoded degree sign is accepted.
+	WGS84Position utf8;
+
+	if (!WGS84Position::parse("N 59\xC2\xB0 58' 55.23\" E 017\xC2\xB0 50' 06.12\"", WGS84Position::WGS84Format::DegreesMinutesSeconds, utf8) ||
+		!compareWithEpsilon(utf8.getLatitude(), dms.getLatitude(), 1e-12)) {
+		std::cerr << "UTF-8 degree sign was rejected." << std::endl;
+		return -1;
+	}
+
+	// Malformed input is rejected without touching the position.
+	if (WGS84Position::parse("N 59 58' E 017 50'", WGS84Position::WGS84Format::DegreesMinutesSeconds, dms) ||
+		WGS84Position::parse("59.3489", WGS84Position::WGS84Format::Degrees, dms) ||
+		WGS84Position::parse("N 95 0' E 017 50'", WGS84Position::WGS84Format::DegreesMinutes, dms) ||
+		WGS84Position::parse("X 59 58' 55.23\" E 017 50' 06.12\"", WGS84Position::WGS84Format::DegreesMinutesSeconds, dms) ||
+		WGS84Position::parse("N 59 58' 55.23\" S 017 50' 06.12\"", WGS84Position::WGS84Format::DegreesMinutesSeconds, dms) ||
+		WGS84Position::parse("N 59 58' 55.23\" E 017 50' 06.12\" X", WGS84Position::WGS84Format::DegreesMinutesSeconds, dms) ||
+		WGS84Position::parse("N 59 58' 55.2x3\" E 017 50' 06.12\"", WGS84Position::WGS84Format::DegreesMinutesSeconds, dms) ||
+		WGS84Position::parse("N 62 10,560' E 015 54.180' garbage", WGS84Position::WGS84Format::DegreesMinutes, dms) ||
+		WGS84Position::parse("59.1abc 18.0", WGS84Position::WGS84Format::Degrees, dms) ||
+		WGS84Position::parse("0x3b 18.0", WGS84Position::WGS84Format::Degrees, dms) ||
+		WGS84Position::parse("nan 18.0", WGS84Position::WGS84Format::Degrees, dms) ||
+		WGS84Position::parseLatitude("N 59 X", WGS84Position::WGS84Format::DegreesMinutes, lat) ||
+		WGS84Position::parseLatitude("S -95\xBA 0'", WGS84Position::WGS84Format::DegreesMinutes, lat) ||
+		WGS84Position::parseLatitude("N 59\xBA 75'", WGS84Position::WGS84Format::DegreesMinutes, lat) ||
+		WGS84Position::parseLatitude("N 59\xBA -30'", WGS84Position::WGS84Format::DegreesMinutes, lat) ||
+		WGS84Position::parseLatitude("N 59\xBA +30'", WGS84Position::WGS84Format::DegreesMinutes, lat) ||
+		WGS84Position::parseLatitude("N 59.5\xBA 30'", WGS84Position::WGS84Format::DegreesMinutes, lat) ||
+		WGS84Position::parseLatitude("- -59\xBA 30'", WGS84Position::WGS84Format::DegreesMinutes, lat) ||
+		WGS84Position::parseLatitude("N 59\xBA 58' 60.00\"", WGS84Position::WGS84Format::DegreesMinutesSeconds, lat) ||
+		WGS84Position::parseLatitude("N 59\xBA 58' -5.00\"", WGS84Position::WGS84Format::DegreesMinutesSeconds, lat) ||
+		WGS84Position::parseLongitude("W 180\xBA 30'", WGS84Position::WGS84Format::DegreesMinutes, lon) ||
+		dms.getLatitude() != reference.getLatitude()) {
+		std::cerr << "Malformed input was accepted." << std::endl;
+		return -1;
+	}
+
+	return 0;
+}
+
+int testGeocentric()
+{
+	Geocentric geocentric;
+	Geocentric::Cartesian equator = geocentric.geodetic_to_geocentric(0.0, 0.0, 0.0);
+	Geocentric::Cartesian pole = geocentric.geodetic_to_geocentric(90.0, 0.0, 0.0);
+
+	if (!compareWithEpsilon(equator.x, 6378137.0, 1e-6) || !compareWithEpsilon(pole.z, 6356752.314140, 1e-5)) {
+		std::cerr << "Geocentric conversion failed." << std::endl;
+		return -1;
+	}
+
+	// Round trip for points over Sweden at different heights.
+	for (int i = 0; i < 100; ++i) {
+		double lat = 55.0 + i * 0.14;
+		double lon = 11.0 + i * 0.12;
+		double height = -50.0 + i * 25.0;
+		Geocentric::Geodetic geodetic = geocentric.geocentric_to_geodetic(geocentric.geodetic_to_geocentric(lat, lon, height));
+
+		if (!compareWithEpsilon(geodetic.latitude, lat, 1e-10) || !compareWithEpsilon(geodetic.longitude, lon, 1e-10) ||
+			!compareWithEpsilon(geodetic.height, height, 1e-5)) {
+			std::cerr << "Geocentric round trip failed." << std::endl;
+			return -1;
+		}
+	}
+
+	// A point 100 metres north of the origin in SWEREF 99 TM grid coordinates
+	// is 100 / 0.9996 metres north on the ground at the central meridian.
+	GaussKreuger projection;
+	projection.swedish_params("sweref_99_tm");
+	GaussKreuger::Coordinate grid[2];
+	grid[0] = projection.geodetic_to_grid(62.0, 15.0);
+	grid[1] = grid[0];
+	grid[1].x += 100.0;
+	double heights[2] = { 10.0, 10.0 };
+	LocalTangentPlane plane(62.0, 15.0, 10.0);
+	Geocentric::Cartesian enu[2];
+	plane.grid_to_enu(projection, grid, heights, enu, 2);
+
+	if (!compareWithEpsilon(enu[0].x, 0.0, 0.002) || !compareWithEpsilon(enu[0].y, 0.0, 0.002) || !compareWithEpsilon(enu[0].z, 0.0, 0.002)) {
+		std::cerr << "Origin is not at zero in the local frame." << std::endl;
+		return -1;
+	}
+
+	if (!compareWithEpsilon(enu[1].y, 100.0 / 0.9996, 0.002) || !compareWithEpsilon(enu[1].x, 0.0, 0.002)) {
+		std::cerr << "Local frame conversion failed." << std::endl;
+		return -1;
+	}
+
+	// And back again.
+	GaussKreuger::Coordinate back[2];
+	double backHeights[2];
+	plane.enu_to_grid(projection, enu, back, backHeights, 2);
+
+	if (!compareWithEpsilon(back[1].x, grid[1].x, 0.0015) || !compareWithEpsilon(back[1].y, grid[1].y, 0.0015) ||
+		!compareWithEpsilon(backHeights[1], 10.0, 1e-4)) {
+		std::cerr << "Local frame round trip failed." << std::endl;
+		return -1;
+	}
+
+	return 0;
+}
+
+int testLazyPosition()
+{
+	const RT90Position rt90(6583052, 1627548);
+	const LazyPosition lazy(rt90);
+	WGS84Position expected = rt90.toWGS84();
+	WGS84Position wgs84 = lazy.toWGS84();
+
+	if (lazy.getSourceGrid() != Position::Grid::RT90 ||
+		wgs84.getLatitude() != expected.getLatitude() || wgs84.getLongitude() != expected.getLongitude()) {
+		std::cerr << "Lazy WGS84 conversion failed." << std::endl;
+		return -1;
+	}
+
+	SWEREF99Position expectedSweref(expected, SWEREF99Position::SWEREFProjection::sweref_99_tm);
+	SWEREF99Position sweref = lazy.toSWEREF99();
+
+	if (sweref.getLatitude() != expectedSweref.getLatitude() || sweref.getLongitude() != expectedSweref.getLongitude()) {
+		std::cerr << "Lazy SWEREF99 conversion failed." << std::endl;
+		return -1;
+	}
+
+	SWEREF99Position expectedLocal(expected, SWEREF99Position::SWEREFProjection::sweref_99_18_00);
+	SWEREF99Position local = lazy.toSWEREF99(SWEREF99Position::SWEREFProjection::sweref_99_18_00);
+
+	if (local.getLatitude() != expectedLocal.getLatitude() || local.getLongitude() != expectedLocal.getLongitude() ||
+		local.getProjection() != SWEREF99Position::SWEREFProjection::sweref_99_18_00) {
+		std::cerr << "Lazy local zone conversion failed." << std::endl;
+		return -1;
+	}
+
+	// The source representation is returned unchanged, also after other RT90 zones were requested.
+	RT90Position source = lazy.toRT90();
+
+	if (source.getLatitude() != rt90.getLatitude() || source.getLongitude() != rt90.getLongitude()) {
+		std::cerr << "Lazy source representation changed." << std::endl;
+		return -1;
+	}
+
+	RT90Position other = lazy.toRT90(RT90Position::RT90Projection::rt90_0_0_gon_v);
+	source = lazy.toRT90(RT90Position::RT90Projection::rt90_2_5_gon_v);
+
+	if (other.getProjection() != RT90Position::RT90Projection::rt90_0_0_gon_v ||
+		source.getLatitude() != rt90.getLatitude() || source.getLongitude() != rt90.getLongitude()) {
+		std::cerr << "Lazy RT90 conversion failed." << std::endl;
+		return -1;
+	}
+
+	// Starting from a SWEREF99 local zone.
+	const LazyPosition fromLocal(expectedLocal);
+	wgs84 = fromLocal.toWGS84();
+
+	if (!compareWithEpsilon(wgs84.getLatitude(), expected.getLatitude(), 1e-7) ||
+		!compareWithEpsilon(wgs84.getLongitude(), expected.getLongitude(), 1e-7)) {
+		std::cerr << "Lazy conversion from local zone failed." << std::endl;
+		return -1;
+	}
+
+	fromLocal.toSWEREF99(SWEREF99Position::SWEREFProjection::sweref_99_12_00);
+	local = fromLocal.toSWEREF99(SWEREF99Position::SWEREFProjection::sweref_99_18_00);
+
+	if (local.getLatitude() != expectedLocal.getLatitude() || local.getLongitude() != expectedLocal.getLongitude()) {
+		std::cerr << "Lazy local zone source changed." << std::endl;
+		return -1;
+	}
+
+	return 0;
+}
+
+int testAreaOfUseMask()
+{
+	GaussKreuger projection;
+
+	if (projection.is_valid() || projection.swedish_params("sweref_99_9999") || projection.is_valid()) {
+		std::cerr << "Unknown projection reported as valid." << std::endl;
+		return -1;
+	}
+
+	projection.swedish_params("sweref_99_tm");
+	// Valid points, garbage at (0,0), swapped latitude and longitude, NaN and
+	// a point in Norway outside the area of use.
+	GaussKreuger::Coordinate geodetic[6];
+	geodetic[0].x = 59.3489;
+	geodetic[0].y = 18.0473;
+	geodetic[1].x = 67.8558;
+	geodetic[1].y = 20.2253;
+	geodetic[3].x = 18.0473;
+	geodetic[3].y = 59.3489;
+	geodetic[4].x = std::numeric_limits<double>::quiet_NaN();
+	geodetic[4].y = 15.0;
+	geodetic[5].x = 70.5;
+	geodetic[5].y = 25.0;
+	GaussKreuger::Coordinate grid[6];
+	unsigned char valid[6];
+	const unsigned char expected[6] = { 1, 1, 0, 0, 0, 0 };
+
+	if (projection.geodetic_to_grid(geodetic, grid, valid, 6) != 2) {
+		std::cerr << "Wrong number of valid geodetic points." << std::endl;
+		return -1;
+	}
+
+	for (int i = 0; i < 6; ++i) {
+		if (valid[i] != expected[i] || (!valid[i] && !std::isnan(grid[i].x))) {
+			std::cerr << "Wrong geodetic validity mask." << std::endl;
+			return -1;
+		}
+	}
+
+	GaussKreuger::Coordinate reference = projection.geodetic_to_grid(geodetic[1].x, geodetic[1].y);
+
+	if (grid[1].x != reference.x || grid[1].y != reference.y) {
+		std::cerr << "Masked conversion differs from single point conversion." << std::endl;
+		return -1;
+	}
+
+	// Grid garbage: zero, swapped northing and easting, and a point far east.
+	grid[2].x = 0.0;
+	grid[2].y = 0.0;
+	grid[3].x = grid[0].y;
+	grid[3].y = grid[0].x;
+	grid[4].x = 6600000.0;
+	grid[4].y = 1200000.0;
+	grid[5] = projection.geodetic_to_grid(70.5, 25.0);
+	GaussKreuger::Coordinate back[6];
+
+	if (projection.grid_to_geodetic(grid, back, valid, 6) != 2) {
+		std::cerr << "Wrong number of valid grid points." << std::endl;
+		return -1;
+	}
+
+	for (int i = 0; i < 6; ++i) {
+		if (valid[i] != expected[i]) {
+			std::cerr << "Wrong grid validity mask." << std::endl;
+			return -1;
+		}
+	}
+
+	if (!compareWithEpsilon(back[0].x, geodetic[0].x, 1e-7) || !compareWithEpsilon(back[0].y, geodetic[0].y, 1e-7)) {
+		std::cerr << "Masked grid conversion failed." << std::endl;
+		return -1;
+	}
+
+	// The grid bounds must enclose the projected area of use of a zone.
+	projection.swedish_params("sweref_99_2015");
+	GaussKreuger::Bounds area = projection.geodetic_bounds();
+	GaussKreuger::Bounds bounds = projection.grid_bounds();
+
+	for (int i = 0; i <= 10; ++i) {
+		for (int j = 0; j <= 10; ++j) {
+			double lat = area.min_x + (area.max_x - area.min_x) * i / 10.0;
+			double lon = area.min_y + (area.max_y - area.min_y) * j / 10.0;
+			GaussKreuger::Coordinate x_y = projection.geodetic_to_grid(lat, lon);
+
+			if (!bounds.contains(x_y.x, x_y.y)) {
+				std::cerr << "Grid bounds do not enclose the area of use." << std::endl;
+				return -1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+int testRasterReprojection()
+{
+	GaussKreuger sweref;
+	sweref.swedish_params("sweref_99_tm");
+	// WGS84 output raster over Stockholm, source raster in SWEREF 99 TM.
+	RasterGrid wgs84Raster(59.40, 17.95, 0.0001, 0.0002, 300, 500);
+	const double tolerance = 0.005;
+	RasterReprojector toSweref(wgs84Raster, nullptr, &sweref, tolerance, 64);
+	std::vector<GaussKreuger::Coordinate> single(wgs84Raster.rows * wgs84Raster.columns);
+	std::vector<GaussKreuger::Coordinate> banded(single.size());
+	size_t evaluations = toSweref.compute(&single[0]);
+
+	if (evaluations * 20 > single.size()) {
+		std::cerr << "Too many exact evaluations: " << evaluations << std::endl;
+		return -1;
+	}
+
+	if (toSweref.compute(&banded[0], 3) != evaluations) {
+		std::cerr << "Parallel evaluation differs." << std::endl;
+		return -1;
+	}
+
+	for (size_t row = 0; row < wgs84Raster.rows; ++row) {
+		for (size_t column = 0; column < wgs84Raster.columns; ++column) {
+			GaussKreuger::Coordinate centre = wgs84Raster.pixel_centre(row, column);
+			GaussKreuger::Coordinate exact = sweref.geodetic_to_grid(centre.x, centre.y);
+			const GaussKreuger::Coordinate& computed = single[row * wgs84Raster.columns + column];
+
+			// Allow for the millimetre rounding of the exact conversion.
+			if (!compareWithEpsilon(computed.x, exact.x, tolerance + 0.001) || !compareWithEpsilon(computed.y, exact.y, tolerance + 0.001)) {
+				std::cerr << "Interpolated coordinate outside tolerance." << std::endl;
+				return -1;
+			}
+
+			if (computed.x != banded[row * wgs84Raster.columns + column].x) {
+				std::cerr << "Row band result differs." << std::endl;
+				return -1;
+			}
+		}
+	}
+
+	// SWEREF 99 TM output raster with 10 m pixels, source in WGS84.
+	RasterGrid swerefRaster(6700000.0, 600000.0, 10.0, 10.0, 257, 129);
+	RasterReprojector toWgs84(swerefRaster, &sweref, nullptr, 1e-9, 32);
+	std::vector<GaussKreuger::Coordinate> geodetic(swerefRaster.rows * swerefRaster.columns);
+	toWgs84.compute(&geodetic[0], 2);
+
+	for (size_t row = 0; row < swerefRaster.rows; row += 7) {
+		for (size_t column = 0; column < swerefRaster.columns; column += 3) {
+			GaussKreuger::Coordinate centre = swerefRaster.pixel_centre(row, column);
+			GaussKreuger::Coordinate exact = sweref.grid_to_geodetic(centre.x, centre.y);
+			const GaussKreuger::Coordinate& computed = geodetic[row * swerefRaster.columns + column];
+
+			if (!compareWithEpsilon(computed.x, exact.x, 1e-9) || !compareWithEpsilon(computed.y, exact.y, 1e-9)) {
+				std::cerr << "Interpolated geodetic coordinate outside tolerance." << std::endl;
+				return -1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+int testEnvelopeTransform()
+{
+	GaussKreuger sweref;
+	sweref.swedish_params("sweref_99_tm");
+	GaussKreuger rt90;
+	rt90.swedish_params("rt90_2.5_gon_v");
+	// A large extent in RT90, to SWEREF 99 TM, and a WGS84 extent to RT90.
+	GaussKreuger::Bounds rt90Extent;
+	rt90Extent.min_x = 6200000.0;
+	rt90Extent.max_x = 7300000.0;
+	rt90Extent.min_y = 1250000.0;
+	rt90Extent.max_y = 1850000.0;
+	GaussKreuger::Bounds wgs84Extent;
+	wgs84Extent.min_x = 55.3;
+	wgs84Extent.max_x = 69.0;
+	wgs84Extent.min_y = 11.0;
+	wgs84Extent.max_y = 24.0;
+	const GaussKreuger* sources[2] = { &rt90, nullptr };
+	const GaussKreuger* targets[2] = { &sweref, &rt90 };
+	const GaussKreuger::Bounds* extents[2] = { &rt90Extent, &wgs84Extent };
+	const double tolerance = 0.5;
+
+	for (int i = 0; i < 2; ++i) {
+		EnvelopeTransform envelope(sources[i], targets[i], tolerance);
+		size_t evaluations = 0;
+		GaussKreuger::Bounds result = envelope.transform(*extents[i], &evaluations);
+		// Brute force reference with dense sampling of the edges.
+		const int samples = 20000;
+		GaussKreuger::Bounds reference;
+		reference.min_x = reference.min_y = std::numeric_limits<double>::max();
+		reference.max_x = reference.max_y = -std::numeric_limits<double>::max();
+
+		for (int j = 0; j <= samples; ++j) {
+			double t = static_cast<double>(j) / samples;
+			GaussKreuger::Coordinate edge[4];
+			edge[0].x = extents[i]->min_x;
+			edge[0].y = extents[i]->min_y + t * (extents[i]->max_y - extents[i]->min_y);
+			edge[1].x = extents[i]->max_x;
+			edge[1].y = edge[0].y;
+			edge[2].x = extents[i]->min_x + t * (extents[i]->max_x - extents[i]->min_x);
+			edge[2].y = extents[i]->min_y;
+			edge[3].x = edge[2].x;
+			edge[3].y = extents[i]->max_y;
+
+			for (int k = 0; k < 4; ++k) {
+				GaussKreuger::Coordinate p = envelope.transform(edge[k]);
+				reference.min_x = std::min(reference.min_x, p.x);
+				reference.max_x = std::max(reference.max_x, p.x);
+				reference.min_y = std::min(reference.min_y, p.y);
+				reference.max_y = std::max(reference.max_y, p.y);
+			}
+		}
+
+		if (result.min_x > reference.min_x || result.max_x < reference.max_x ||
+			result.min_y > reference.min_y || result.max_y < reference.max_y) {
+			std::cerr << "Envelope does not enclose the transformed rectangle." << std::endl;
+			return -1;
+		}
+
+		if (reference.min_x - result.min_x > 2 * tolerance || result.max_x - reference.max_x > 2 * tolerance ||
+			reference.min_y - result.min_y > 2 * tolerance || result.max_y - reference.max_y > 2 * tolerance) {
+			std::cerr << "Envelope is larger than needed." << std::endl;
+			return -1;
+		}
+
+		if (evaluations > 2000) {
+			std::cerr << "Too many evaluations for envelope: " << evaluations << std::endl;
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+int testWebMercator()
+{
+	GaussKreuger::Coordinate corner = WebMercator::geodetic_to_mercator(0.0, 180.0);
+	GaussKreuger::Coordinate top = WebMercator::geodetic_to_mercator(90.0, 0.0);
+
+	if (!compareWithEpsilon(corner.y, 20037508.342789244, 1e-6) || !compareWithEpsilon(top.x, 20037508.342789244, 1e-6)) {
+		std::cerr << "Web Mercator extent is wrong." << std::endl;
+		return -1;
+	}
+
+	GaussKreuger::Coordinate mercator = WebMercator::geodetic_to_mercator(59.3293, 18.0686);
+	GaussKreuger::Coordinate back = WebMercator::mercator_to_geodetic(mercator.x, mercator.y);
+
+	if (!compareWithEpsilon(back.x, 59.3293, 1e-10) || !compareWithEpsilon(back.y, 18.0686, 1e-10)) {
+		std::cerr << "Web Mercator round trip failed." << std::endl;
+		return -1;
+	}
+
+	// Example from the Bing Maps tile system documentation.
+	WebMercator::TileKey example(3, 5, 3);
+
+	if (WebMercator::quadkey_string(example) != "213" || WebMercator::quadkey(example) != 39) {
+		std::cerr << "Wrong quadkey." << std::endl;
+		return -1;
+	}
+
+	WebMercator::TileKey stockholm = WebMercator::geodetic_to_tile(59.3293, 18.0686, 10);
+
+	if (stockholm.x != 563 || stockholm.y != 301) {
+		std::cerr << "Wrong tile index." << std::endl;
+		return -1;
+	}
+
+	WebMercator::TileKey decoded = WebMercator::quadkey_to_tile(WebMercator::quadkey(stockholm), 10);
+
+	if (decoded.x != stockholm.x || decoded.y != stockholm.y) {
+		std::cerr << "Quadkey decoding failed." << std::endl;
+		return -1;
+	}
+
+	// Zoom levels beyond max_zoom are clamped.
+	WebMercator::TileKey deep = WebMercator::geodetic_to_tile(59.3406, 18.0569, 40);
+	WebMercator::TileKey deepest = WebMercator::geodetic_to_tile(59.3406, 18.0569, WebMercator::max_zoom);
+
+	if (deep.zoom != WebMercator::max_zoom || deep.x != deepest.x || deep.y != deepest.y ||
+		WebMercator::quadkey_string(WebMercator::TileKey(1, 1, 64)).size() != WebMercator::max_zoom ||
+		WebMercator::quadkey_to_tile(~uint64_t(0), 64).zoom != WebMercator::max_zoom) {
+		std::cerr << "Zoom level was not clamped." << std::endl;
+		return -1;
+	}
+
+	// Fused conversion from RT90 must match the step by step conversion.
+	GaussKreuger rt90;
+	rt90.swedish_params("rt90_2.5_gon_v");
+	std::vector<GaussKreuger::Coordinate> grid(1000);
+
+	for (size_t i = 0; i < grid.size(); ++i) {
+		grid[i].x = 6200000.0 + i * 1000.0;
+		grid[i].y = 1300000.0 + i * 500.0;
+	}
+
+	std::vector<WebMercator::TileKey> tiles(grid.size());
+	std::vector<uint64_t> quadkeys(grid.size());
+	std::vector<GaussKreuger::Coordinate> projected(grid.size());
+	WebMercator::grid_to_tile(rt90, &grid[0], &tiles[0], grid.size(), 17);
+	WebMercator::grid_to_quadkey(rt90, &grid[0], &quadkeys[0], grid.size(), 17);
+	WebMercator::grid_to_mercator(rt90, &grid[0], &projected[0], grid.size());
+
+	for (size_t i = 0; i < grid.size(); ++i) {
+		WGS84Position wgs84 = RT90Position(grid[i].x, grid[i].y).toWGS84();
+		WebMercator::TileKey expected = WebMercator::geodetic_to_tile(wgs84.getLatitude(), wgs84.getLongitude(), 17);
+		GaussKreuger::Coordinate expectedMercator = WebMercator::geodetic_to_mercator(wgs84.getLatitude(), wgs84.getLongitude());
+
+		if (tiles[i].x != expected.x || tiles[i].y != expected.y || quadkeys[i] != WebMercator::quadkey(expected) ||
+			projected[i].x != expectedMercator.x || projected[i].y != expectedMercator.y) {
+			std::cerr << "Fused tile conversion differs." << std::endl;
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+int testGeodesic()
+{
+	// Flinders Peak to Buninyong on GRS 80, the worked example published by
+	// Geoscience Australia for Vincenty's formulae.
+	double lat1 = -(37.0 + 57.0 / 60.0 + 3.72030 / 3600.0);
+	double lon1 = 144.0 + 25.0 / 60.0 + 29.52440 / 3600.0;
+	double lat2 = -(37.0 + 39.0 / 60.0 + 10.15610 / 3600.0);
+	double lon2 = 143.0 + 55.0 / 60.0 + 35.38390 / 3600.0;
+	double forward = 306.0 + 52.0 / 60.0 + 5.37 / 3600.0;
+	double back = 127.0 + 10.0 / 60.0 + 25.07 / 3600.0;
+	Geodesic geodesic;
+	Geodesic::InverseResult inverse = geodesic.inverse(lat1, lon1, lat2, lon2);
+
+	if (!inverse.converged || !compareWithEpsilon(inverse.distance, 54972.271, 0.001) ||
+		!compareWithEpsilon(inverse.forward_azimuth, forward, 0.01 / 3600.0) || !compareWithEpsilon(inverse.back_azimuth, back, 0.01 / 3600.0)) {
+		std::cerr << "Geodesic inverse failed." << std::endl;
+		return -1;
+	}
+
+	Geodesic::DirectResult direct = geodesic.direct(lat1, lon1, forward, 54972.271);
+
+	if (!compareWithEpsilon(direct.latitude, lat2, 0.0001 / 3600.0) || !compareWithEpsilon(direct.longitude, lon2, 0.0001 / 3600.0) ||
+		!compareWithEpsilon(direct.azimuth, back + 180.0, 0.01 / 3600.0)) {
+		std::cerr << "Geodesic direct failed." << std::endl;
+		return -1;
+	}
+
+	// Distance matrices must match single inverse solutions.
+	std::vector<GaussKreuger::Coordinate> stops(40);
+
+	for (size_t i = 0; i < stops.size(); ++i) {
+		stops[i].x = 55.5 + 0.3 * i;
+		stops[i].y = 12.0 + 0.25 * ((i * 7) % 40);
+	}
+
+	std::vector<double> symmetric(stops.size() * stops.size());
+	std::vector<double> rectangular(10 * stops.size());
+	geodesic.distance_matrix(&stops[0], stops.size(), &symmetric[0]);
+	geodesic.distance_matrix(&stops[0], 10, &stops[0], stops.size(), &rectangular[0]);
+	std::vector<Geodesic::InverseResult> pairs(stops.size() - 1);
+	geodesic.inverse(&stops[0], &stops[1], &pairs[0], pairs.size());
+
+	for (size_t i = 0; i < stops.size(); ++i) {
+		for (size_t j = 0; j < stops.size(); ++j) {
+			double expected = geodesic.inverse(stops[i].x, stops[i].y, stops[j].x, stops[j].y).distance;
+
+			if (!compareWithEpsilon(symmetric[i * stops.size() + j], expected, 1e-6) ||
+				(i < 10 && !compareWithEpsilon(rectangular[i * stops.size() + j], expected, 1e-6)) ||
+				(j == i + 1 && !compareWithEpsilon(pairs[i].distance, expected, 1e-6))) {
+				std::cerr << "Distance matrix differs from single solution." << std::endl;
+				return -1;
+			}
+		}
+	}
+
+	// Nearly antipodal points where the iteration fails are marked, not
+	// given the distance of the last iteration.
+	GaussKreuger::Coordinate antipodal[3];
+	antipodal[0].x = 0.0;
+	antipodal[0].y = 0.0;
+	antipodal[1].x = 0.5;
+	antipodal[1].y = 179.7;
+	antipodal[2].x = 1.0;
+	antipodal[2].y = 1.0;
+	double antipodalDistances[9];
+
+	if (geodesic.inverse(0.0, 0.0, 0.5, 179.7).converged ||
+		geodesic.distance_matrix(antipodal, 3, antipodalDistances) != 1 ||
+		!std::isnan(antipodalDistances[1]) || !std::isnan(antipodalDistances[3]) || std::isnan(antipodalDistances[2]) ||
+		geodesic.distance_matrix(antipodal, 1, antipodal, 3, antipodalDistances) != 1 ||
+		!std::isnan(antipodalDistances[1]) || std::isnan(antipodalDistances[2])) {
+		std::cerr << "Non converged distances were not marked." << std::endl;
+		return -1;
+	}
+
+	return 0;
+}
+
+int testSpatialIndex()
+{
+	GaussKreuger sweref;
+	sweref.swedish_params("sweref_99_tm");
+
+	// The scale factor is 0.9996 on the central meridian and matches the
+	// ratio of grid distance to geodesic distance elsewhere.
+	if (!compareWithEpsilon(sweref.scale_factor(62.0, 15.0), 0.9996, 1e-9)) {
+		std::cerr << "Wrong scale factor on the central meridian." << std::endl;
+		return -1;
+	}
+
+	Geodesic geodesic;
+	double lat = 59.3489;
+	double lon = 18.0473;
+	Geodesic::DirectResult moved = geodesic.direct(lat, lon, 45.0, 1000.0);
+	GaussKreuger::Coordinate start = sweref.geodetic_to_grid(lat, lon);
+	GaussKreuger::Coordinate end = sweref.geodetic_to_grid(moved.latitude, moved.longitude);
+	double gridDistance = sqrt((end.x - start.x) * (end.x - start.x) + (end.y - start.y) * (end.y - start.y));
+	double midScale = sweref.scale_factor((lat + moved.latitude) / 2.0, (lon + moved.longitude) / 2.0);
+
+	if (!compareWithEpsilon(gridDistance / 1000.0, midScale, 3e-6)) {
+		std::cerr << "Scale factor does not match geodesic distance." << std::endl;
+		return -1;
+	}
+
+	// Pseudo random road nodes around Stockholm.
+	std::vector<GaussKreuger::Coordinate> nodes(5000);
+	unsigned seed = 12345;
+
+	for (size_t i = 0; i < nodes.size(); ++i) {
+		seed = seed * 1103515245u + 12345u;
+		nodes[i].x = 59.30 + 0.1 * ((seed >> 8) & 0xffff) / 65536.0;
+		seed = seed * 1103515245u + 12345u;
+		nodes[i].y = 17.95 + 0.2 * ((seed >> 8) & 0xffff) / 65536.0;
+	}
+
+	// Around Stockholm, and near the eastern edge of SWEREF 99 TM where the
+	// scale factor changes fastest.
+	const double centres[2][2] = { { 59.30, 17.95 }, { 65.80, 23.30 } };
+	const double radii[2] = { 250.0, 5000.0 };
+
+	for (int area = 0; area < 2; ++area) {
+		std::vector<GaussKreuger::Coordinate> points(nodes);
+
+		for (size_t i = 0; i < points.size(); ++i) {
+			points[i].x += centres[area][0] - 59.30;
+			points[i].y += centres[area][1] - 17.95;
+		}
+
+		SpatialIndex index = SpatialIndex::from_geodetic(sweref, &points[0], points.size());
+		std::vector<GaussKreuger::Coordinate> grid(points.size());
+		sweref.geodetic_to_grid(&points[0], &grid[0], points.size());
+		std::vector<SpatialIndex::Neighbour> found;
+		const double radius = radii[area];
+
+		for (int query = 0; query < 20; ++query) {
+			double queryLat = centres[area][0] + 0.01 + query * 0.004;
+			double queryLon = centres[area][1] + 0.02 + query * 0.008;
+			// Reference distances on the ellipsoid, from the indexed grid points.
+			std::vector<double> distances(grid.size());
+
+			for (size_t i = 0; i < grid.size(); ++i) {
+				GaussKreuger::Coordinate point = sweref.grid_to_geodetic(grid[i].x, grid[i].y);
+				distances[i] = geodesic.inverse(queryLat, queryLon, point.x, point.y).distance;
+			}
+
+			// Within a millimetre of the geodesic distance, allowing for the
+			// millimetre rounding of the grid coordinates.
+			const double tolerance = 0.002;
+			index.radius_search(queryLat, queryLon, radius, found);
+			size_t inside = 0;
+			size_t near = 0;
+
+			for (size_t i = 0; i < distances.size(); ++i) {
+				inside += distances[i] <= radius - tolerance ? 1 : 0;
+				near += distances[i] <= radius + tolerance ? 1 : 0;
+			}
+
+			if (found.size() < inside || found.size() > near) {
+				std::cerr << "Radius search returned wrong number of points." << std::endl;
+				return -1;
+			}
+
+			for (size_t i = 0; i < found.size(); ++i) {
+				if (fabs(found[i].distance - distances[found[i].index]) > tolerance || (i > 0 && found[i].distance < found[i - 1].distance)) {
+					std::cerr << "Radius search returned wrong distance " << found[i].distance << " for "
+							  << distances[found[i].index] << std::endl;
+					return -1;
+				}
+			}
+
+			index.nearest(queryLat, queryLon, 7, found);
+			std::vector<double> sorted(distances);
+			std::sort(sorted.begin(), sorted.end());
+
+			if (found.size() != 7) {
+				std::cerr << "Nearest search returned wrong number of points." << std::endl;
+				return -1;
+			}
+
+			for (size_t i = 0; i < found.size(); ++i) {
+				if (fabs(found[i].distance - sorted[i]) > tolerance || fabs(distances[found[i].index] - sorted[i]) > tolerance) {
+					std::cerr << "Nearest search returned wrong points." << std::endl;
+					return -1;
+				}
+			}
+		}
+	}
+
+	return 0;
+}
+
+int testConversionBatcher()
+{
+	RT90Position::RT90Projection rt90Projection = RT90Position::RT90Projection::rt90_2_5_gon_v;
+	GaussKreuger rt90;
+	rt90.swedish_params(RT90Position::getProjectionName(rt90Projection));
+	const size_t threadCount = 8;
+	const size_t perThread = 250;
+	std::vector<GaussKreuger::Coordinate> results(threadCount * perThread);
+	std::vector<std::thread> threads;
+	size_t batches = 0;
+
+	{
+		ConversionBatcher batcher(64, std::chrono::microseconds(500));
+
+		for (size_t t = 0; t < threadCount; ++t) {
+			threads.push_back(std::thread([&batcher, &results, t, rt90Projection]() {
+				std::vector<std::future<GaussKreuger::Coordinate> > futures;
+
+				for (size_t i = 0; i < perThread; ++i) {
+					RT90Position position(6583052.0 + 10.0 * i, 1627548.0 + 100.0 * t, rt90Projection);
+					futures.push_back(batcher.toWGS84(position));
+				}
+
+				for (size_t i = 0; i < perThread; ++i) {
+					results[t * perThread + i] = futures[i].get();
+				}
+			}));
+		}
+
+		for (size_t t = 0; t < threads.size(); ++t) {
+			threads[t].join();
+		}
+
+		// A multi point request and an unknown projection.
+		GaussKreuger::Coordinate points[3];
+
+		for (size_t i = 0; i < 3; ++i) {
+			points[i].x = 59.0 + i;
+			points[i].y = 18.0 - i;
+		}
+
+		std::vector<GaussKreuger::Coordinate> grid =
+			batcher.submit("sweref_99_tm", ConversionBatcher::Direction::GeodeticToGrid, points, 3).get();
+		GaussKreuger sweref;
+		sweref.swedish_params("sweref_99_tm");
+
+		for (size_t i = 0; i < 3; ++i) {
+			GaussKreuger::Coordinate expected = sweref.geodetic_to_grid(points[i].x, points[i].y);
+
+			if (grid.size() != 3 || grid[i].x != expected.x || grid[i].y != expected.y) {
+				std::cerr << "Batched multi point request differs from direct conversion." << std::endl;
+				return -1;
+			}
+		}
+
+		try {
+			batcher.submit("no_such_projection", ConversionBatcher::Direction::GeodeticToGrid, points[0]).get();
+			std::cerr << "Unknown projection was accepted." << std::endl;
+			return -1;
+		} catch (const std::invalid_argument&) {
+		}
+
+		batches = batcher.batches();
+	}
+
+	for (size_t t = 0; t < threadCount; ++t) {
+		for (size_t i = 0; i < perThread; ++i) {
+			GaussKreuger::Coordinate expected = rt90.grid_to_geodetic(6583052.0 + 10.0 * i, 1627548.0 + 100.0 * t);
+			const GaussKreuger::Coordinate& result = results[t * perThread + i];
+
+			if (result.x != expected.x || result.y != expected.y) {
+				std::cerr << "Batched conversion differs from direct conversion." << std::endl;
+				return -1;
+			}
+		}
+	}
+
+	// Requests must have been coalesced.
+	if (batches >= results.size()) {
+		std::cerr << "Requests were not coalesced: " << batches << " batches." << std::endl;
+		return -1;
+	}
+
+	return 0;
+}
+
+static void releaseTestSchema(ArrowSchema* schema)
+{
+	schema->release = nullptr;
+}
+
+static void releaseTestArray(ArrowArray* array)
+{
+	array->release = nullptr;
+}
+
+int testArrowConversion()
+{
+	// Columns with one leading row skipped by the offset and a null in row 2.
+	double latitudes[6] = { 0.0, 59.0, 60.0, 61.0, 62.0, 63.0 };
+	double longitudes[6] = { 0.0, 18.0, 17.0, 16.0, 15.0, 14.0 };
+	uint8_t validity[1] = { 0xff & ~(1 << 3) };
+	const void* latitudeBuffers[2] = { validity, latitudes };
+	const void* longitudeBuffers[2] = { nullptr, longitudes };
+	ArrowSchema columnSchema;
+	std::memset(&columnSchema, 0, sizeof(columnSchema));
+	columnSchema.format = "g";
+	columnSchema.release = releaseTestSchema;
+	ArrowArray latitudeArray;
+	std::memset(&latitudeArray, 0, sizeof(latitudeArray));
+	latitudeArray.length = 5;
+	latitudeArray.null_count = 1;
+	latitudeArray.offset = 1;
+	latitudeArray.n_buffers = 2;
+	latitudeArray.buffers = latitudeBuffers;
+	latitudeArray.release = releaseTestArray;
+	ArrowArray longitudeArray = latitudeArray;
+	longitudeArray.null_count = 0;
+	longitudeArray.buffers = longitudeBuffers;
+
+	ArrowSchema schema;
+	ArrowArray array;
+
+	if (vti_arrow_convert("wgs84", "sweref_99_tm", &columnSchema, &latitudeArray, &columnSchema, &longitudeArray, &schema, &array) != 0) {
+		std::cerr << "Arrow conversion failed." << std::endl;
+		return -1;
+	}
+
+	GaussKreuger sweref;
+	sweref.swedish_params("sweref_99_tm");
+
+	if (std::string(schema.format) != "+s" || schema.n_children != 2 || std::string(schema.children[0]->name) != "x" ||
+			array.length != 5 || array.n_children != 2 || array.children[0]->null_count != 1 || array.children[1]->null_count != 1) {
+		std::cerr << "Unexpected Arrow output layout." << std::endl;
+		return -1;
+	}
+
+	const double* x = static_cast<const double*>(array.children[0]->buffers[1]);
+	const double* y = static_cast<const double*>(array.children[1]->buffers[1]);
+	const uint8_t* outValidity = static_cast<const uint8_t*>(array.children[1]->buffers[0]);
+
+	for (int i = 0; i < 5; ++i) {
+		bool valid = (outValidity[0] >> i) & 1;
+		GaussKreuger::Coordinate expected = sweref.geodetic_to_grid(latitudes[i + 1], longitudes[i + 1]);
+
+		if (valid != (i != 2) || (valid && (x[i] != expected.x || y[i] != expected.y))) {
+			std::cerr << "Wrong Arrow conversion result in row " << i << "." << std::endl;
+			return -1;
+		}
+	}
+
+	// Grid to grid, taking the output columns as input.
+	ArrowSchema rt90Schema;
+	ArrowArray rt90Array;
+
+	if (vti_arrow_convert("sweref_99_tm", "rt90_2.5_gon_v", schema.children[0], array.children[0], schema.children[1], array.children[1], &rt90Schema, &rt90Array) != 0) {
+		std::cerr << "Arrow grid to grid conversion failed." << std::endl;
+		return -1;
+	}
+
+	RT90Position rt90(WGS84Position(latitudes[1], longitudes[1]), RT90Position::RT90Projection::rt90_2_5_gon_v);
+
+	if (!compareWithEpsilon(static_cast<const double*>(rt90Array.children[0]->buffers[1])[0], rt90.getLatitude(), 1e-3) ||
+			!compareWithEpsilon(static_cast<const double*>(rt90Array.children[1]->buffers[1])[0], rt90.getLongitude(), 1e-3)) {
+		std::cerr << "Wrong Arrow grid to grid result." << std::endl;
+		return -1;
+	}
+
+	schema.release(&schema);
+	array.release(&array);
+	rt90Schema.release(&rt90Schema);
+	rt90Array.release(&rt90Array);
+
+	if (schema.release || array.release || rt90Schema.release || rt90Array.release) {
+		std::cerr << "Arrow release callbacks did not mark the structs released." << std::endl;
+		return -1;
+	}
+
+	// Unsupported input.
+	columnSchema.format = "f";
+
+	if (vti_arrow_convert("wgs84", "sweref_99_tm", &columnSchema, &latitudeArray, &columnSchema, &longitudeArray, &schema, &array) != EINVAL ||
+			vti_arrow_convert("wgs84", "mercator", &columnSchema, &latitudeArray, &columnSchema, &longitudeArray, &schema, &array) != EINVAL) {
+		std::cerr << "Invalid Arrow input was accepted." << std::endl;
+		return -1;
+	}
+
+	// Crafted lengths fail with an error code instead of an exception.
+	columnSchema.format = "g";
+	ArrowArray hugeLatitudes = latitudeArray;
+	ArrowArray hugeLongitudes = longitudeArray;
+	hugeLatitudes.null_count = hugeLongitudes.null_count = 0;
+	hugeLatitudes.offset = hugeLongitudes.offset = 0;
+	hugeLatitudes.length = hugeLongitudes.length = std::numeric_limits<int64_t>::max();
+
+	if (vti_arrow_convert("wgs84", "sweref_99_tm", &columnSchema, &hugeLatitudes, &columnSchema, &hugeLongitudes, &schema, &array) != EINVAL) {
+		std::cerr << "Arrow length overflowing size_t was accepted." << std::endl;
+		return -1;
+	}
+
+	hugeLatitudes.length = hugeLongitudes.length = static_cast<int64_t>(std::numeric_limits<size_t>::max() / sizeof(double));
+
+	if (vti_arrow_convert("wgs84", "sweref_99_tm", &columnSchema, &hugeLatitudes, &columnSchema, &hugeLongitudes, &schema, &array) != ENOMEM) {
+		std::cerr << "Unallocatable Arrow length was accepted." << std::endl;
+		return -1;
+	}
+
+	return 0;
+}
+
+#ifdef HAVE_CONVERSION_SERVER
+// Raw connection to the server, bypassing ConversionClient.
+int connectRaw(const char* socketPath)
+{
+	sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	strncpy(address.sun_path, socketPath, sizeof(address.sun_path) - 1);
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+	if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+		close(fd);
+		return -1;
+	}
+
+	return fd;
+}
+
+#ifdef __linux__
+// Send a handshake on fd for a region of size bytes announcing capacity
+// coordinates.
+bool sendHandshake(int fd, size_t size, uint64_t capacity, bool seal)
+{
+	int memoryFd = memfd_create("vti-conversion-test", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+
+	if (fd < 0 || memoryFd < 0 || ftruncate(memoryFd, static_cast<off_t>(size)) != 0 ||
+		(seal && fcntl(memoryFd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW) != 0)) {
+		if (memoryFd >= 0) {
+			close(memoryFd);
+		}
+
+		return false;
+	}
+
+	// Same layout as the handshake in conversionserver.cpp.
+	struct {
+		uint32_t magic;
+		uint32_t reserved;
+		uint64_t capacity;
+	} hello = { 0x56544943, 0, capacity };
+	iovec data;
+	data.iov_base = &hello;
+	data.iov_len = sizeof(hello);
+	union {
+		cmsghdr header;
+		char buffer[CMSG_SPACE(sizeof(int))];
+	} control;
+	memset(&control, 0, sizeof(control));
+	msghdr message;
+	memset(&message, 0, sizeof(message));
+	message.msg_iov = &data;
+	message.msg_iovlen = 1;
+	message.msg_control = control.buffer;
+	message.msg_controllen = sizeof(control.buffer);
+	cmsghdr* header = CMSG_FIRSTHDR(&message);
+	header->cmsg_level = SOL_SOCKET;
+	header->cmsg_type = SCM_RIGHTS;
+	header->cmsg_len = CMSG_LEN(sizeof(int));
+	memcpy(CMSG_DATA(header), &memoryFd, sizeof(int));
+	bool sent = sendmsg(fd, &message, 0) == static_cast<ssize_t>(sizeof(hello));
+	close(memoryFd);
+	return sent;
+}
+
+// Returns true if the server drops the connection after the handshake.
+bool rejectsHandshake(const char* socketPath, size_t size, uint64_t capacity, bool seal)
+{
+	int fd = connectRaw(socketPath);
+	bool sent = sendHandshake(fd, size, capacity, seal);
+	timeval timeout;
+	timeout.tv_sec = 5;
+	timeout.tv_usec = 0;
+	setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+	char byte;
+	bool closed = sent && recv(fd, &byte, 1, 0) == 0;
+
+	if (fd >= 0) {
+		close(fd);
+	}
+
+	return closed;
+}
+
+// Connect, and send requests without reading the responses until the
+// connection is backed up. Returns the connection, or -1 on failure.
+int connectFlooding(const char* socketPath)
+{
+	int fd = connectRaw(socketPath);
+
+	if (!sendHandshake(fd, 4096, 256, true)) {
+		if (fd >= 0) {
+			close(fd);
+		}
+
+		return -1;
+	}
+
+	// Same layout as a request in conversionserver.cpp.
+	struct {
+		uint32_t magic;
+		uint32_t direction;
+		uint64_t offset;
+		uint64_t count;
+		char projection[32];
+	} request;
+	memset(&request, 0, sizeof(request));
+	request.magic = 0x56544943;
+	request.count = 1;
+	strcpy(request.projection, "sweref_99_tm");
+	size_t accepted = 0;
+
+	// Stop when the server no longer reads, with a bound in case it buffers
+	// responses without limit.
+	while (accepted < 1000000) {
+		ssize_t sent = send(fd, &request, sizeof(request), MSG_DONTWAIT | MSG_NOSIGNAL);
+
+		if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+			// Let the server catch up once more, then the buffers are full.
+			usleep(50000);
+
+			if (send(fd, &request, sizeof(request), MSG_DONTWAIT | MSG_NOSIGNAL) < 0) {
+				break;
+			}
+		} else if (sent < 0) {
+			close(fd);
+			return -1;
+		}
+
+		++accepted;
+	}
+
+	return fd;
+}
+#endif
+
+int testConversionServer()
+{
+	char socketPath[64];
+	snprintf(socketPath, sizeof(socketPath), "/tmp/vti-conversion-test-%ld.sock", static_cast<long>(getpid()));
+	ConversionServer server(socketPath);
+
+	if (!server.listen()) {
+		std::cerr << "Server could not listen." << std::endl;
+		return -1;
+	}
+
+	std::thread serverThread(&ConversionServer::run, &server);
+	int result = 0;
+
+	// A running server is not replaced.
+	{
+		ConversionServer second(socketPath);
+
+		if (second.listen() || errno != EADDRINUSE) {
+			std::cerr << "Running server was replaced." << std::endl;
+			result = -1;
+		}
+	}
+
+	// A client that never completes the handshake must not stall the others.
+	int silent = connectRaw(socketPath);
+
+	if (silent < 0) {
+		std::cerr << "Raw connection failed." << std::endl;
+		result = -1;
+	}
+
+#ifdef __linux__
+	// A capacity that overflows the size in bytes, a capacity larger than
+	// the region, and a region that is not sealed are all rejected.
+	if (!rejectsHandshake(socketPath, 4096, (uint64_t(1) << 60) + 1, true) ||
+		!rejectsHandshake(socketPath, 4096, 4096, true) ||
+		!rejectsHandshake(socketPath, 4096, 256, false)) {
+		std::cerr << "Invalid handshake was accepted." << std::endl;
+		result = -1;
+	}
+
+	// A client that sends requests but never reads the responses must not
+	// stall the others either.
+	int flooding = connectFlooding(socketPath);
+
+	if (flooding < 0) {
+		std::cerr << "Flooding connection failed." << std::endl;
+		result = -1;
+	}
+#else
+	const int flooding = -1;
+#endif
+
+	{
+		// A small region, so the batch cycles through the ring many times.
+		ConversionClient client;
+
+		if (!client.connect(socketPath, 1000)) {
+			std::cerr << "Client could not connect." << std::endl;
+			result = -1;
+		}
+
+		std::vector<GaussKreuger::Coordinate> geodetic(10007);
+
+		for (size_t i = 0; i < geodetic.size(); ++i) {
+			geodetic[i].x = 55.5 + 13.0 * i / geodetic.size();
+			geodetic[i].y = 12.0 + 11.0 * ((i * 7919) % geodetic.size()) / geodetic.size();
+		}
+
+		std::vector<GaussKreuger::Coordinate> grid(geodetic.size());
+		std::vector<GaussKreuger::Coordinate> back(geodetic.size());
+		GaussKreuger sweref;
+		sweref.swedish_params("sweref_99_tm");
+
+		if (result == 0 && (!client.geodetic_to_grid("sweref_99_tm", &geodetic[0], &grid[0], grid.size()) ||
+							!client.grid_to_geodetic("sweref_99_tm", &grid[0], &back[0], back.size()))) {
+			std::cerr << "Remote conversion failed." << std::endl;
+			result = -1;
+		}
+
+		for (size_t i = 0; result == 0 && i < geodetic.size(); ++i) {
+			GaussKreuger::Coordinate expected = sweref.geodetic_to_grid(geodetic[i].x, geodetic[i].y);
+			GaussKreuger::Coordinate expectedBack = sweref.grid_to_geodetic(expected.x, expected.y);
+
+			if (grid[i].x != expected.x || grid[i].y != expected.y || back[i].x != expectedBack.x || back[i].y != expectedBack.y) {
+				std::cerr << "Remote conversion differs from local conversion." << std::endl;
+				result = -1;
+			}
+		}
+
+		// Unknown projections fail without breaking the connection.
+		if (result == 0 && client.geodetic_to_grid("no_such_projection", &geodetic[0], &grid[0], 3000)) {
+			std::cerr << "Unknown projection was accepted." << std::endl;
+			result = -1;
+		}
+
+		if (result == 0 && (!client.is_connected() || !client.geodetic_to_grid("rt90_2.5_gon_v", &geodetic[0], &grid[0], 1))) {
+			std::cerr << "Connection broken after failed request." << std::endl;
+			result = -1;
+		}
+	}
+
+	if (silent >= 0) {
+		close(silent);
+	}
+
+	if (flooding >= 0) {
+		close(flooding);
+	}
+
+	server.stop();
+	serverThread.join();
+	return result;
+}
+
+int testConversionServerSocketPath()
+{
+	char path[64];
+	snprintf(path, sizeof(path), "/tmp/vti-conversion-path-%ld", static_cast<long>(getpid()));
+
+	// A file that is not a socket is never removed.
+	FILE* file = fopen(path, "w");
+
+	if (!file) {
+		std::cerr << "Could not create " << path << std::endl;
+		return -1;
+	}
+
+	fclose(file);
+	int result = 0;
+
+	{
+		ConversionServer server(path);
+
+		if (server.listen() || errno != ENOTSOCK) {
+			std::cerr << "Listening on a regular file succeeded." << std::endl;
+			result = -1;
+		}
+	}
+
+	struct stat status;
+
+	if (stat(path, &status) != 0 || !S_ISREG(status.st_mode)) {
+		std::cerr << "Regular file at the socket path was removed." << std::endl;
+		result = -1;
+	}
+
+	unlink(path);
+
+	// A socket left behind by a server that is gone is replaced.
+	sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	strncpy(address.sun_path, path, sizeof(address.sun_path) - 1);
+	int stale = socket(AF_UNIX, SOCK_STREAM, 0);
+
+	if (stale < 0 || bind(stale, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+		std::cerr << "Could not create a stale socket." << std::endl;
+		result = -1;
+	}
+
+	if (stale >= 0) {
+		close(stale);
+	}
+
+	{
+		ConversionServer server(path);
+
+		if (result == 0 && !server.listen()) {
+			std::cerr << "Stale socket was not replaced." << std::endl;
+			result = -1;
+		}
+	}
+
+	unlink(path);
+	return result;
+}
+#endif
+
+int testHelmert()
+{
+	Helmert toSweref = Helmert::rt90_to_sweref99();
+	Helmert toRT90 = toSweref.inverse();
+	GaussKreuger rt90;
+	rt90.swedish_params("rt90_2.5_gon_v");
+	GaussKreuger besselRT90;
+	besselRT90.swedish_params("bessel_rt90_2.5_gon_v");
+	std::vector<double> latitudes;
+	std::vector<double> longitudes;
+
+	for (double lat = 55.5; lat <= 68.5; lat += 1.0) {
+		for (double lon = 12.0; lon <= 23.0; lon += 1.0) {
+			latitudes.push_back(lat);
+			longitudes.push_back(lon);
+		}
+	}
+
+	const size_t count = latitudes.size();
+	std::vector<double> besselLatitudes(count);
+	std::vector<double> besselLongitudes(count);
+	std::vector<double> heights(count);
+	toRT90.transform(&latitudes[0], &longitudes[0], nullptr, &besselLatitudes[0], &besselLongitudes[0], &heights[0], count);
+
+	for (size_t i = 0; i < count; ++i) {
+		// The batch version matches the single point version.
+		Geocentric::Geodetic single = toRT90.transform(latitudes[i], longitudes[i]);
+
+		if (!compareWithEpsilon(single.latitude, besselLatitudes[i], 1e-12) || !compareWithEpsilon(single.longitude, besselLongitudes[i], 1e-12) ||
+				!compareWithEpsilon(single.height, heights[i], 1e-6)) {
+			std::cerr << "Batch Helmert transform differs from single point transform." << std::endl;
+			return -1;
+		}
+
+		// The RT90 parameters for GRS 80 are chosen to absorb the datum shift,
+		// so projecting the shifted Bessel coordinates must agree with them.
+		GaussKreuger::Coordinate direct = rt90.geodetic_to_grid(latitudes[i], longitudes[i]);
+		GaussKreuger::Coordinate rigorous = besselRT90.geodetic_to_grid(besselLatitudes[i], besselLongitudes[i]);
+
+		if (fabs(direct.x - rigorous.x) > 1.0 || fabs(direct.y - rigorous.y) > 1.0) {
+			std::cerr << "Helmert transformed RT90 differs by " << direct.x - rigorous.x << ", " << direct.y - rigorous.y
+					  << " m at " << latitudes[i] << ", " << longitudes[i] << std::endl;
+			return -1;
+		}
+
+		// Round trip through the inverse.
+		Geocentric::Geodetic back = toSweref.transform(besselLatitudes[i], besselLongitudes[i], heights[i]);
+
+		if (!compareWithEpsilon(back.latitude, latitudes[i], 1e-10) || !compareWithEpsilon(back.longitude, longitudes[i], 1e-10) ||
+				!compareWithEpsilon(back.height, 0.0, 1e-4)) {
+			std::cerr << "Helmert round trip failed." << std::endl;
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+// Reference Douglas-Peucker on fully projected points.
+static void douglasPeucker(const std::vector<GaussKreuger::Coordinate>& grid, size_t first, size_t last, double tolerance, std::vector<unsigned char>& keep)
+{
+	const GaussKreuger::Coordinate& a = grid[first];
+	const GaussKreuger::Coordinate& b = grid[last];
+	double dx = b.x - a.x;
+	double dy = b.y - a.y;
+	double length2 = dx * dx + dy * dy;
+	size_t farthest = first;
+	double maximum = 0.0;
+
+	for (size_t k = first + 1; k < last; ++k) {
+		double t = length2 > 0.0 ? ((grid[k].x - a.x) * dx + (grid[k].y - a.y) * dy) / length2 : 0.0;
+		t = std::min(1.0, std::max(0.0, t));
+		double ex = grid[k].x - (a.x + t * dx);
+		double ey = grid[k].y - (a.y + t * dy);
+		double distance = sqrt(ex * ex + ey * ey);
+
+		if (distance > maximum) {
+			maximum = distance;
+			farthest = k;
+		}
+	}
+
+	if (maximum > tolerance) {
+		keep[farthest] = 1;
+		douglasPeucker(grid, first, farthest, tolerance, keep);
+		douglasPeucker(grid, farthest, last, tolerance, keep);
+	}
+}
+
+int testTrajectorySimplifier()
+{
+	GaussKreuger sweref;
+	sweref.swedish_params("sweref_99_tm");
+	DatasetGenerator generator;
+	std::vector<GaussKreuger::Coordinate> track = generator.trajectories(20000, 5000);
+	std::vector<GaussKreuger::Coordinate> grid(track.size());
+	sweref.geodetic_to_grid(&track[0], &grid[0], track.size());
+	TrajectorySimplifier simplifier(sweref);
+	const double tolerances[4] = { 0.5, 2.0, 10.0, 50.0 };
+
+	for (int t = 0; t < 4; ++t) {
+		// Each generated track is simplified on its own.
+		for (size_t begin = 0; begin < track.size(); begin += 5000) {
+			std::vector<unsigned char> keep(5000, 0);
+			keep[0] = keep[4999] = 1;
+			std::vector<GaussKreuger::Coordinate> trackGrid(grid.begin() + begin, grid.begin() + begin + 5000);
+			douglasPeucker(trackGrid, 0, 4999, tolerances[t], keep);
+			std::vector<GaussKreuger::Coordinate> simplified;
+			std::vector<size_t> indices;
+			simplifier.simplify(&track[begin], 5000, tolerances[t], simplified, &indices);
+			std::vector<size_t> expected;
+
+			for (size_t i = 0; i < keep.size(); ++i) {
+				if (keep[i]) {
+					expected.push_back(i);
+				}
+			}
+
+			if (indices != expected || simplified.size() != indices.size()) {
+				std::cerr << "Simplified track differs from reference at tolerance " << tolerances[t] << ": "
+						  << indices.size() << " vs " << expected.size() << " points." << std::endl;
+				return -1;
+			}
+
+			for (size_t i = 0; i < indices.size(); ++i) {
+				if (simplified[i].x != trackGrid[indices[i]].x || simplified[i].y != trackGrid[indices[i]].y) {
+					std::cerr << "Wrong grid coordinate for retained point." << std::endl;
+					return -1;
+				}
+			}
+
+			// Dense tracks are simplified without projecting most points.
+			if (tolerances[t] >= 2.0 && simplifier.projections() > 5000 / 2) {
+				std::cerr << "Too many projections: " << simplifier.projections() << " at tolerance " << tolerances[t] << std::endl;
+				return -1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+int testIncrementalConverter()
+{
+	GaussKreuger rt90;
+	rt90.swedish_params("rt90_2.5_gon_v");
+	DatasetGenerator generator;
+	std::vector<GaussKreuger::Coordinate> grid = generator.uniformSweden(100000);
+	rt90.geodetic_to_grid(&grid[0], &grid[0], grid.size());
+	const char* cachePath = "incremental-test.cache";
+	std::remove(cachePath);
+	std::vector<GaussKreuger::Coordinate> output(grid.size());
+	std::vector<GaussKreuger::Coordinate> expected(grid.size());
+
+	// First run, without a cache, converts every block.
+	IncrementalConverter first(rt90, IncrementalConverter::Direction::GridToGeodetic, 1024);
+
+	if (first.load(cachePath)) {
+		std::cerr << "Loaded a missing cache." << std::endl;
+		return -1;
+	}
+
+	first.convert(&grid[0], &output[0], grid.size());
+
+	if (first.reconverted() != first.blocks() || first.blocks() < 20 || !first.save(cachePath)) {
+		std::cerr << "First run converted " << first.reconverted() << " of " << first.blocks() << " blocks." << std::endl;
+		return -1;
+	}
+
+	// Nightly edits: a few records change, one is inserted and one removed.
+	grid[500].x += 1.0;
+	grid[40000].y -= 2.0;
+	grid[90000].x += 3.0;
+	grid.insert(grid.begin() + 60000, grid[12345]);
+	grid.erase(grid.begin() + 75000);
+	rt90.grid_to_geodetic(&grid[0], &expected[0], grid.size());
+
+	IncrementalConverter second(rt90, IncrementalConverter::Direction::GridToGeodetic, 1024);
+
+	if (!second.load(cachePath)) {
+		std::cerr << "Unable to load cache." << std::endl;
+		return -1;
+	}
+
+	second.convert(&grid[0], &output[0], grid.size());
+
+	if (second.reconverted() > 8) {
+		std::cerr << "Reconverted " << second.reconverted() << " of " << second.blocks() << " blocks for five edits." << std::endl;
+		return -1;
+	}
+
+	for (size_t i = 0; i < grid.size(); ++i) {
+		if (output[i].x != expected[i].x || output[i].y != expected[i].y) {
+			std::cerr << "Incremental result differs from direct conversion at " << i << std::endl;
+			return -1;
+		}
+	}
+
+	// Unchanged input reuses every block, also when converting in place.
+	second.convert(&grid[0], &grid[0], grid.size());
+
+	if (second.reconverted() != 0 || grid[12345].x != expected[12345].x) {
+		std::cerr << "Unchanged input reconverted " << second.reconverted() << " blocks." << std::endl;
+		return -1;
+	}
+
+	// A cache for another projection or direction is ignored.
+	GaussKreuger zone;
+	zone.swedish_params("rt90_5.0_gon_v");
+	IncrementalConverter otherProjection(zone, IncrementalConverter::Direction::GridToGeodetic, 1024);
+	IncrementalConverter otherDirection(rt90, IncrementalConverter::Direction::GeodeticToGrid, 1024);
+
+	if (otherProjection.load(cachePath) || otherDirection.load(cachePath)) {
+		std::cerr << "Loaded a cache for another projection." << std::endl;
+		return -1;
+	}
+
+	std::remove(cachePath);
+	return 0;
+}
+
+int testCovariancePropagation()
+{
+	const char* projections[3] = { "sweref_99_tm", "sweref_99_1800", "rt90_2.5_gon_v" };
+	const double deg_to_rad = M_PI / 180.0;
+	// GRS 80
+	const double axis = 6378137.0;
+	const double e2 = 0.0066943800229;
+	DatasetGenerator generator;
+	std::vector<GaussKreuger::Coordinate> points = generator.uniformSweden(1000);
+
+	for (int p = 0; p < 3; ++p) {
+		GaussKreuger projection;
+		projection.swedish_params(projections[p]);
+		std::vector<GaussKreuger::Covariance> covariances(points.size());
+		std::vector<GaussKreuger::Coordinate> grid(points.size());
+		std::vector<GaussKreuger::Covariance> gridCovariances(points.size());
+
+		for (size_t i = 0; i < points.size(); ++i) {
+			double latitude = points[i].x;
+			double longitude = points[i].y;
+
+			// Analytic Jacobian against central differences.
+			GaussKreuger::Jacobian jacobian = projection.jacobian(latitude, longitude);
+			const double h = 1e-3;
+			GaussKreuger::Coordinate north = projection.geodetic_to_grid(latitude + h, longitude);
+			GaussKreuger::Coordinate south = projection.geodetic_to_grid(latitude - h, longitude);
+			GaussKreuger::Coordinate east = projection.geodetic_to_grid(latitude, longitude + h);
+			GaussKreuger::Coordinate west = projection.geodetic_to_grid(latitude, longitude - h);
+			double errors[4] = {
+				jacobian.dx_dlatitude - (north.x - south.x) / (2.0 * h),
+				jacobian.dy_dlatitude - (north.y - south.y) / (2.0 * h),
+				jacobian.dx_dlongitude - (east.x - west.x) / (2.0 * h),
+				jacobian.dy_dlongitude - (east.y - west.y) / (2.0 * h)
+			};
+
+			for (int k = 0; k < 4; ++k) {
+				// Metres per degree, about 1e5.
+				if (fabs(errors[k]) > 2.0) {
+					std::cerr << "Jacobian differs from finite differences by " << errors[k] << " in " << projections[p] << std::endl;
+					return -1;
+				}
+			}
+
+			// One metre of uncertainty in every direction on the ellipsoid is
+			// the scale factor in every direction in the conformal grid.
+			double w = 1.0 - e2 * sin(latitude * deg_to_rad) * sin(latitude * deg_to_rad);
+			double meridian = axis * (1.0 - e2) / (w * sqrt(w)) * deg_to_rad;
+			double parallel = axis / sqrt(w) * cos(latitude * deg_to_rad) * deg_to_rad;
+			covariances[i].xx = 1.0 / (meridian * meridian);
+			covariances[i].yy = 1.0 / (parallel * parallel);
+			GaussKreuger::Covariance gridCovariance;
+			GaussKreuger::Coordinate x_y = projection.geodetic_to_grid(latitude, longitude, covariances[i], gridCovariance);
+			GaussKreuger::Coordinate plain = projection.geodetic_to_grid(latitude, longitude);
+			double scale = projection.scale_factor(latitude, longitude);
+
+			if (x_y.x != plain.x || x_y.y != plain.y ||
+				fabs(gridCovariance.xx - scale * scale) > 1e-9 || fabs(gridCovariance.yy - scale * scale) > 1e-9 ||
+				fabs(gridCovariance.xy) > 1e-9) {
+				std::cerr << "Wrong grid covariance " << gridCovariance.xx << ", " << gridCovariance.xy << ", " << gridCovariance.yy
+						  << " for scale " << scale << " in " << projections[p] << std::endl;
+				return -1;
+			}
+
+			// And back again.
+			GaussKreuger::Covariance geodeticCovariance;
+			projection.grid_to_geodetic(x_y.x, x_y.y, gridCovariance, geodeticCovariance);
+
+			if (fabs(geodeticCovariance.xx / covariances[i].xx - 1.0) > 1e-6 || fabs(geodeticCovariance.yy / covariances[i].yy - 1.0) > 1e-6 ||
+				fabs(geodeticCovariance.xy) > 1e-6 * covariances[i].xx) {
+				std::cerr << "Covariance round trip failed in " << projections[p] << std::endl;
+				return -1;
+			}
+		}
+
+		// The batch versions give the same results.
+		projection.geodetic_to_grid(&points[0], &covariances[0], &grid[0], &gridCovariances[0], points.size());
+
+		for (size_t i = 0; i < points.size(); ++i) {
+			GaussKreuger::Covariance single;
+			GaussKreuger::Coordinate x_y = projection.geodetic_to_grid(points[i].x, points[i].y, covariances[i], single);
+
+			if (grid[i].x != x_y.x || grid[i].y != x_y.y || gridCovariances[i].xx != single.xx ||
+				gridCovariances[i].xy != single.xy || gridCovariances[i].yy != single.yy) {
+				std::cerr << "Batch covariance differs from single point." << std::endl;
+				return -1;
+			}
+		}
+
+		projection.grid_to_geodetic(&grid[0], &gridCovariances[0], &grid[0], &gridCovariances[0], grid.size());
+
+		for (size_t i = 0; i < points.size(); ++i) {
+			if (fabs(gridCovariances[i].xx / covariances[i].xx - 1.0) > 1e-6 || fabs(grid[i].x - points[i].x) > 1e-7) {
+				std::cerr << "Batch covariance round trip failed." << std::endl;
+				return -1;
+			}
+		}
+	}
+
+	// A correlated, elongated ellipse keeps its area up to the scale factor.
+	GaussKreuger sweref;
+	sweref.swedish_params("sweref_99_tm");
+	GaussKreuger::Covariance ellipse;
+	ellipse.xx = 4e-10;
+	ellipse.xy = 3e-10;
+	ellipse.yy = 9e-10;
+	GaussKreuger::Covariance gridEllipse;
+	sweref.geodetic_to_grid(63.0, 16.0, ellipse, gridEllipse);
+	GaussKreuger::Jacobian jacobian = sweref.jacobian(63.0, 16.0);
+	double determinant = jacobian.dx_dlatitude * jacobian.dy_dlongitude - jacobian.dx_dlongitude * jacobian.dy_dlatitude;
+	double area = gridEllipse.xx * gridEllipse.yy - gridEllipse.xy * gridEllipse.xy;
+	double expected = (ellipse.xx * ellipse.yy - ellipse.xy * ellipse.xy) * determinant * determinant;
+
+	if (fabs(area / expected - 1.0) > 1e-9) {
+		std::cerr << "Covariance determinant not preserved." << std::endl;
+		return -1;
+	}
+
+	return 0;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc != 2) {
+		std::cerr << "Unknown test number" << std::endl;
+		return -1;
+	}
+
+	int retVal = -1;
+	// Get test number
+	int testNumber = atoi(argv[1]);
+
+	switch (testNumber) {
+		case 1:
+			retVal = testRT90ToWGS84();
+			break;
+
+		case 2:
+			retVal = testWGS84ToRT90();
+			break;
+
+		case 3:
+			retVal = testWGS84ToSweRef();
+			break;
+
+		case 4:
+			retVal = testSweRefToWGS84();
+			break;
+
+		case 5:
+			retVal = testWGS84Parse();
+			break;
+
+		case 6:
+			retVal = testTrajectoryCodec();
+			break;
+
+		case 7:
+			retVal = testRealTimeNoAllocation();
+			break;
+
+		case 8:
+			retVal = testGeocentric();
+			break;
+
+		case 9:
+			retVal = testLazyPosition();
+			break;
+
+		case 10:
+			retVal = testAreaOfUseMask();
+			break;
+
+		case 11:
+			retVal = testRasterReprojection();
+			break;
+
+		case 12:
+			retVal = testEnvelopeTransform();
+			break;
+
+		case 13:
+			retVal = testWebMercator();
+			break;
+
+		case 14:
+			retVal = testGeodesic();
+			break;
+
+		case 15:
+			retVal = testSpatialIndex();
+			break;
+
+		case 16:
+			retVal = testConversionBatcher();
+			break;
+
+#ifdef HAVE_CONVERSION_SERVER
+
+		case 17:
+			retVal = testConversionServer();
+			break;
+#endif
+
+		case 18:
+			retVal = testArrowConversion();
+			break;
+
+		case 19:
+			retVal = testHelmert();
+			break;
+
+		case 20:
+			retVal = testTrajectorySimplifier();
+			break;
+
+		case 21:
+			retVal = testIncrementalConverter();
+			break;
+
+		case 22:
+			retVal = testCovariancePropagation();
+			break;
+
+#ifdef HAVE_CONVERSION_SERVER
+
+		case 23:
+			retVal = testConversionServerSocketPath();
 			break;
+#endif
 
 		default:
 			std::cerr << "Unknown test" << std::endl;
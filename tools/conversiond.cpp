@@ -0,0 +1,47 @@
+/*
+ * conversiond.cpp
+ *
+ *  Created on: October 19, 2026
+ *      Author: Bjorn Blissing
+ */
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+
+#include "conversionserver.h"
+
+using namespace vti;
+
+static ConversionServer* runningServer = nullptr;
+
+extern "C" void handleSignal(int)
+{
+	if (runningServer) {
+		runningServer->stop();
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc != 2) {
+		std::cerr << "Usage: conversiond <socket path>" << std::endl;
+		return -1;
+	}
+
+	ConversionServer server(argv[1]);
+
+	if (!server.listen()) {
+		std::cerr << "Unable to listen on " << argv[1] << ": " << strerror(errno) << std::endl;
+		return -1;
+	}
+
+	runningServer = &server;
+	signal(SIGINT, handleSignal);
+	signal(SIGTERM, handleSignal);
+	signal(SIGPIPE, SIG_IGN);
+	server.run();
+	runningServer = nullptr;
+	return 0;
+}
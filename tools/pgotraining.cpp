@@ -0,0 +1,66 @@
+/*
+ * pgotraining.cpp
+ *
+ *  Created on: October 19, 2026
+ *      Author: Bjorn Blissing
+ */
+
+// Training workload for profile guided optimization. Runs the same mix of
+// conversions and parsing as the throughput benchmarks, on a smaller scale,
+// so the profile reflects how the library is used.
+
+#include <iostream>
+
+#include "datasetgenerator.h"
+#include "rt90position.h"
+#include "sweref99position.h"
+#include "wgs84position.h"
+
+using namespace vti;
+
+int main()
+{
+	DatasetGenerator generator;
+	double sink = 0.0;
+
+	// Single point conversions through the position classes.
+	std::vector<GaussKreuger::Coordinate> points = generator.uniformSweden(200000);
+
+	for (size_t i = 0; i < points.size(); ++i) {
+		SWEREF99Position sweref(WGS84Position(points[i].x, points[i].y), SWEREF99Position::SWEREFProjection::sweref_99_tm);
+		sink += sweref.toWGS84().getLatitude();
+	}
+
+	std::vector<DatasetGenerator::RT90Point> rt90Points = generator.mixedRT90(200000);
+
+	for (size_t i = 0; i < rt90Points.size(); ++i) {
+		RT90Position rt90(rt90Points[i].grid.x, rt90Points[i].grid.y, rt90Points[i].projection);
+		sink += rt90.toWGS84().getLatitude();
+	}
+
+	// Batch conversions, plain and masked.
+	std::vector<GaussKreuger::Coordinate> track = generator.trajectories(200000);
+	std::vector<GaussKreuger::Coordinate> grid(track.size());
+	std::vector<unsigned char> valid(track.size());
+	GaussKreuger projection;
+	projection.swedish_params("sweref_99_tm");
+	projection.geodetic_to_grid(&track[0], &grid[0], track.size());
+	projection.grid_to_geodetic(&grid[0], &grid[0], grid.size());
+	projection.geodetic_to_grid(&track[0], &grid[0], &valid[0], track.size());
+	sink += grid[0].x;
+
+	// Parsing, well formed and malformed.
+	WGS84Position position;
+	size_t parsed = 0;
+	std::vector<std::string> corpus = generator.dmsCorpus(100000);
+	std::vector<std::string> malformed = generator.malformedCorpus(100000);
+	corpus.insert(corpus.end(), malformed.begin(), malformed.end());
+
+	for (size_t i = 0; i < corpus.size(); ++i) {
+		parsed += WGS84Position::parse(corpus[i].c_str(), WGS84Position::WGS84Format::DegreesMinutesSeconds, position) ? 1 : 0;
+	}
+
+	std::cout << "Trained on " << points.size() + rt90Points.size() + 3 * track.size() << " conversions and "
+			  << corpus.size() << " strings (" << parsed << " parsed, checksum " << sink << ")." << std::endl;
+	return 0;
+}